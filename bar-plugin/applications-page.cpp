@@ -18,8 +18,10 @@
 #include "applications-page.h"
 
 #include "category.h"
+#include "desktop-entry-loader.h"
 #include "launcher.h"
 #include "launcher-view.h"
+#include "memory-report.h"
 #include "section-button.h"
 #include "settings.h"
 #include "slot.h"
@@ -45,10 +47,80 @@ enum
 
 //-----------------------------------------------------------------------------
 
+static void measure_menu(MemoryReport& report, PojkMenu* menu)
+{
+	if (!menu)
+	{
+		return;
+	}
+
+	report.add_object(MemoryReport::Menu, menu);
+
+	PojkMenuDirectory* directory = pojk_menu_get_directory(menu);
+	if (directory)
+	{
+		report.add_object(MemoryReport::Menu, directory);
+		report.add_string(MemoryReport::Menu, pojk_menu_directory_get_name(directory));
+		report.add_string(MemoryReport::Menu, pojk_menu_directory_get_comment(directory));
+		report.add_string(MemoryReport::Menu, pojk_menu_directory_get_icon_name(directory));
+	}
+
+	// Menu items are counted by their launchers
+	GList* elements = pojk_menu_get_elements(menu);
+	for (GList* li = elements; li != NULL; li = li->next)
+	{
+		if (POJK_IS_MENU(li->data))
+		{
+			measure_menu(report, POJK_MENU(li->data));
+		}
+		else if (POJK_IS_MENU_SEPARATOR(li->data))
+		{
+			report.add_object(MemoryReport::Menu, li->data);
+		}
+	}
+	g_list_free(elements);
+}
+
+//-----------------------------------------------------------------------------
+
+// Plain callbacks, so that menu changes are connected without allocating a
+// slot for every directory and item
+static void directory_changed(PojkMenu*, PojkMenuDirectory*, PojkMenuDirectory*, ReloadCoordinator* reload)
+{
+	reload->menu_changed();
+}
+
+static void item_changed(PojkMenuItem* item, ReloadCoordinator* reload)
+{
+	reload->item_changed(item);
+}
+
+//-----------------------------------------------------------------------------
+
+ApplicationsPage::Contents::Contents() :
+	custom_menu_file(wm_settings->custom_menu_file),
+	load_hierarchy(wm_settings->load_hierarchy),
+	pojk_menu(NULL),
+	pojk_settings_menu(NULL),
+	dictionary(NULL),
+	fold_time(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+
 ApplicationsPage::ApplicationsPage(Window* window) :
 	Page(window),
 	m_pojk_menu(NULL),
 	m_pojk_settings_menu(NULL),
+	m_dictionary(NULL),
+	m_reload(this),
+	m_pending(NULL),
+	m_loading(NULL),
+	m_load_thread(NULL),
+	m_load_finished_id(0),
+	m_loaded(false),
+	m_load_idle_id(0),
 	m_load_status(STATUS_INVALID)
 {
 	// Set desktop environment for applications
@@ -68,6 +140,22 @@ ApplicationsPage::ApplicationsPage(Window* window) :
 
 ApplicationsPage::~ApplicationsPage()
 {
+	if (m_load_idle_id)
+	{
+		g_source_remove(m_load_idle_id);
+	}
+
+	if (m_load_thread)
+	{
+		finish_loading();
+	}
+
+	if (m_pending)
+	{
+		free_contents(*m_pending);
+		delete m_pending;
+	}
+
 	clear_applications();
 }
 
@@ -157,12 +245,31 @@ void ApplicationsPage::apply_filter(GtkToggleButton* togglebutton)
 void ApplicationsPage::invalidate_applications()
 {
 	m_load_status = STATUS_INVALID;
+
+	// Reload right away instead of when the menu is next shown; a load
+	// that is already running is restarted when it finishes
+	if (wm_settings->load_background && !m_load_idle_id && !m_load_thread)
+	{
+		m_load_idle_id = g_idle_add((GSourceFunc)&ApplicationsPage::load_idle, this);
+	}
 }
 
 //-----------------------------------------------------------------------------
 
 void ApplicationsPage::load_applications()
 {
+	// Wait for menu being loaded in the background
+	if (m_load_thread)
+	{
+		finish_loading();
+	}
+
+	// Show menu loaded in the background
+	if (m_pending)
+	{
+		show_pending();
+	}
+
 	// Check if already loaded
 	if (m_load_status == STATUS_LOADED)
 	{
@@ -172,9 +279,53 @@ void ApplicationsPage::load_applications()
 
 	// Load menu
 	clear_applications();
-	load_contents();
+	Contents contents;
+	if (load_contents(contents))
+	{
+		swap_contents(contents);
+		show_contents();
+		m_load_status = STATUS_LOADED;
+	}
+	else
+	{
+		free_contents(contents);
+		m_load_status = STATUS_INVALID;
+	}
+}
 
-	return;
+//-----------------------------------------------------------------------------
+
+void ApplicationsPage::update_display()
+{
+	// Menus that are not on screen yet pick up the settings when loaded,
+	// and menus read from desktop entries have no tree to rebuild from
+	if (m_pending || (m_load_status != STATUS_LOADED) || !m_pojk_menu)
+	{
+		invalidate_applications();
+		return;
+	}
+
+	get_window()->unset_items();
+	get_view()->unset_model();
+
+	// Recreate display text from the launchers that are already loaded
+	Contents contents;
+	for (std::map<std::string, Launcher*>::const_iterator i = m_items.begin(), end = m_items.end(); i != end; ++i)
+	{
+		i->second->update_text(contents.launcher_options);
+	}
+
+	// Rebuild categories from the menu that is already loaded
+	swap_contents(contents);
+	for (std::vector<Category*>::const_iterator i = contents.categories.begin(), end = contents.categories.end(); i != end; ++i)
+	{
+		delete *i;
+	}
+	contents.categories.clear();
+	load_categories(contents);
+	swap_contents(contents);
+
+	show_categories();
 }
 
 //-----------------------------------------------------------------------------
@@ -189,108 +340,384 @@ void ApplicationsPage::reload_category_icon_size()
 
 //-----------------------------------------------------------------------------
 
-void ApplicationsPage::clear_applications()
+void ApplicationsPage::measure(MemoryReport& report) const
 {
-	// Free categories
-	for (std::vector<Category*>::iterator i = m_categories.begin(), end = m_categories.end(); i != end; ++i)
+	report.add_map(MemoryReport::Launchers, m_items);
+	for (std::map<std::string, Launcher*>::const_iterator i = m_items.begin(), end = m_items.end(); i != end; ++i)
 	{
-		delete *i;
+		report.add_string(MemoryReport::Launchers, i->first);
+		i->second->measure(report);
+	}
+
+	report.add_vector(MemoryReport::Categories, m_categories);
+	for (std::vector<Category*>::const_iterator i = m_categories.begin(), end = m_categories.end(); i != end; ++i)
+	{
+		(*i)->measure(report);
+	}
+
+	if (m_dictionary)
+	{
+		m_dictionary->measure(report);
 	}
-	m_categories.clear();
 
+	measure_menu(report, m_pojk_menu);
+	measure_menu(report, m_pojk_settings_menu);
+}
+
+//-----------------------------------------------------------------------------
+
+void ApplicationsPage::clear_applications()
+{
 	// Free menu items
 	get_window()->unset_items();
 	get_view()->unset_model();
 
-	for (std::map<std::string, Launcher*>::iterator i = m_items.begin(), end = m_items.end(); i != end; ++i)
+	Contents contents;
+	swap_contents(contents);
+	free_contents(contents);
+}
+
+//-----------------------------------------------------------------------------
+
+void ApplicationsPage::free_contents(Contents& contents)
+{
+	// Free categories
+	for (std::vector<Category*>::iterator i = contents.categories.begin(), end = contents.categories.end(); i != end; ++i)
+	{
+		delete *i;
+	}
+	contents.categories.clear();
+
+	// Free menu items, disconnecting them as the menu library may keep
+	// items alive; directories are freed with their menus
+	for (std::map<std::string, Launcher*>::iterator i = contents.items.begin(), end = contents.items.end(); i != end; ++i)
 	{
+		g_signal_handlers_disconnect_by_data(i->second->get_menu_item(), &m_reload);
 		delete i->second;
 	}
-	m_items.clear();
+	contents.items.clear();
+	delete contents.dictionary;
+	contents.dictionary = NULL;
+
+	// Stop watching application folders
+	for (std::vector<GFileMonitor*>::const_iterator i = contents.monitors.begin(), end = contents.monitors.end(); i != end; ++i)
+	{
+		g_file_monitor_cancel(*i);
+		g_object_unref(*i);
+	}
+	contents.monitors.clear();
 
 	// Free menu
-	if (G_LIKELY(m_pojk_menu))
+	if (G_LIKELY(contents.pojk_menu))
 	{
-		g_object_unref(m_pojk_menu);
-		m_pojk_menu = NULL;
+		g_object_unref(contents.pojk_menu);
+		contents.pojk_menu = NULL;
 	}
 
 	// Free settings menu
-	if (G_LIKELY(m_pojk_settings_menu))
+	if (G_LIKELY(contents.pojk_settings_menu))
 	{
-		g_object_unref(m_pojk_settings_menu);
-		m_pojk_settings_menu = NULL;
+		g_object_unref(contents.pojk_settings_menu);
+		contents.pojk_settings_menu = NULL;
 	}
 }
 
 //-----------------------------------------------------------------------------
 
-void ApplicationsPage::load_contents()
+void ApplicationsPage::swap_contents(Contents& contents)
+{
+	std::swap(m_pojk_menu, contents.pojk_menu);
+	std::swap(m_pojk_settings_menu, contents.pojk_settings_menu);
+	m_categories.swap(contents.categories);
+	m_items.swap(contents.items);
+	std::swap(m_dictionary, contents.dictionary);
+	m_monitors.swap(contents.monitors);
+	m_reload.swap_files(contents.files);
+}
+
+//-----------------------------------------------------------------------------
+
+bool ApplicationsPage::load_contents(Contents& contents)
 {
-	// Create menu
-	if (wm_settings->custom_menu_file.empty())
+	const gint64 start = g_get_monotonic_time();
+	contents.dictionary = new TokenDictionary;
+
+	// Skip the menu tree if only the flat list of the default applications
+	// is needed
+	const bool native = !contents.load_hierarchy
+			&& contents.custom_menu_file.empty()
+			&& DesktopEntryLoader::enabled()
+			&& load_desktop_entries(contents);
+	if (!native)
 	{
-		m_pojk_menu = pojk_menu_new_applications();
+		// Create menu
+		if (contents.custom_menu_file.empty())
+		{
+			contents.pojk_menu = pojk_menu_new_applications();
+		}
+		else
+		{
+			contents.pojk_menu = pojk_menu_new_for_path(contents.custom_menu_file.c_str());
+		}
+
+		// Load menu
+		if (contents.pojk_menu && !pojk_menu_load(contents.pojk_menu, NULL, NULL))
+		{
+			g_object_unref(contents.pojk_menu);
+			contents.pojk_menu = NULL;
+		}
+
+		if (!contents.pojk_menu)
+		{
+			return false;
+		}
+
+		g_signal_connect_slot<PojkMenu*>(contents.pojk_menu, "reload-required", &ReloadCoordinator::menu_changed, &m_reload);
 	}
-	else
+
+	// Create settings menu
+	gchar* path = xfce_resource_lookup(XFCE_RESOURCE_CONFIG, "menus/blade-settings-manager.menu");
+	contents.pojk_settings_menu = pojk_menu_new_for_path(path != NULL ? path : SETTINGS_MENUFILE);
+	g_free(path);
+
+	if (contents.pojk_settings_menu)
 	{
-		m_pojk_menu = pojk_menu_new_for_path(wm_settings->custom_menu_file.c_str());
+		g_signal_connect_slot<PojkMenu*>(contents.pojk_settings_menu, "reload-required", &ReloadCoordinator::menu_changed, &m_reload);
 	}
 
-	// Load menu
-	if (m_pojk_menu && !pojk_menu_load(m_pojk_menu, NULL, NULL))
+	// Load settings menu
+	if (contents.pojk_settings_menu && !pojk_menu_load(contents.pojk_settings_menu, NULL, NULL))
 	{
-		g_object_unref(m_pojk_menu);
-		m_pojk_menu = NULL;
+		g_object_unref(contents.pojk_settings_menu);
+		contents.pojk_settings_menu = NULL;
 	}
 
-	if (!m_pojk_menu)
+	load_categories(contents);
+	g_debug("Loaded %" G_GSIZE_FORMAT " launchers from %s in %" G_GINT64_FORMAT " us",
+			contents.items.size(), native ? "desktop entries" : "menu", g_get_monotonic_time() - start);
+	g_debug("Accent folding of launcher names took %" G_GINT64_FORMAT " us", contents.fold_time);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool ApplicationsPage::load_desktop_entries(Contents& contents)
+{
+	DesktopEntryLoader loader(contents.launcher_options);
+	loader.load();
+	if (loader.get_entries().empty())
 	{
-		m_load_status = STATUS_INVALID;
-		return;
+		return false;
 	}
 
-	g_signal_connect_slot<PojkMenu*>(m_pojk_menu, "reload-required", &ApplicationsPage::invalidate_applications, this);
-	load_menu(m_pojk_menu, NULL);
+	// Create categories from directory files of the default menu
+	const std::vector<std::string>& directories = loader.get_directories();
+	std::vector<Category*> categories(directories.size(), NULL);
+	for (std::vector<std::string>::size_type i = 0, end = directories.size(); i < end; ++i)
+	{
+		if (directories[i].empty())
+		{
+			continue;
+		}
 
-	// Create settings menu
-	gchar* path = xfce_resource_lookup(XFCE_RESOURCE_CONFIG, "menus/blade-settings-manager.menu");
-	m_pojk_settings_menu = pojk_menu_new_for_path(path != NULL ? path : SETTINGS_MENUFILE);
-	g_free(path);
+		GFile* file = g_file_new_for_path(directories[i].c_str());
+		PojkMenuDirectory* directory = pojk_menu_directory_new(file);
+		g_object_unref(file);
+		if (pojk_menu_directory_get_visible(directory))
+		{
+			categories[i] = new Category(directory);
+		}
+		g_object_unref(directory);
+	}
 
-	if (m_pojk_settings_menu)
+	// Create launchers for entries that are shown, in an order that does not
+	// depend on the threads so that search tokens get the same ids
+	const std::vector<DesktopEntryLoader::Entry>& entries = loader.get_entries();
+	for (std::vector<DesktopEntryLoader::Entry>::const_iterator i = entries.begin(), end = entries.end(); i != end; ++i)
 	{
-		g_signal_connect_slot<PojkMenu*>(m_pojk_settings_menu, "reload-required", &ApplicationsPage::invalidate_applications, this);
+		Launcher* launcher = new Launcher(i->menu_item, contents.dictionary, *i->text);
+		contents.fold_time += i->text->fold_time;
+		contents.items.insert(std::make_pair(i->desktop_id, launcher));
+		ReloadCoordinator::track(contents.files, i->path.c_str());
+
+		for (std::vector<Category*>::size_type j = 0, categories_end = categories.size(); j < categories_end; ++j)
+		{
+			if ((i->directories & (1 << j)) && categories[j])
+			{
+				categories[j]->append_item(launcher);
+			}
+		}
 	}
 
-	// Load settings menu
-	if (m_pojk_settings_menu && pojk_menu_load(m_pojk_settings_menu, NULL, NULL))
+	// Free unused categories
+	for (std::vector<Category*>::const_iterator i = categories.begin(), end = categories.end(); i != end; ++i)
 	{
-		load_menu(m_pojk_settings_menu, NULL);
+		if (*i && !(*i)->empty())
+		{
+			contents.categories.push_back(*i);
+		}
+		else
+		{
+			delete *i;
+		}
+	}
+
+	// Reload when applications are added or removed
+	const std::vector<std::string>& folders = loader.get_folders();
+	for (std::vector<std::string>::const_iterator i = folders.begin(), end = folders.end(); i != end; ++i)
+	{
+		GFile* file = g_file_new_for_path(i->c_str());
+		GFileMonitor* monitor = g_file_monitor_directory(file, G_FILE_MONITOR_NONE, NULL, NULL);
+		g_object_unref(file);
+		if (monitor)
+		{
+			g_signal_connect_slot(monitor, "changed", &ReloadCoordinator::file_changed, &m_reload);
+			contents.monitors.push_back(monitor);
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+void ApplicationsPage::load_categories(Contents& contents)
+{
+	if (contents.pojk_menu)
+	{
+		load_menu(contents, contents.pojk_menu, NULL);
+	}
+	if (contents.pojk_settings_menu)
+	{
+		load_menu(contents, contents.pojk_settings_menu, NULL);
+	}
+
+	// Sort items once, and rank them so that categories sort by integer
+	std::vector<Launcher*> launchers;
+	launchers.reserve(contents.items.size());
+	for (std::map<std::string, Launcher*>::const_iterator i = contents.items.begin(), end = contents.items.end(); i != end; ++i)
+	{
+		launchers.push_back(i->second);
+	}
+	std::sort(launchers.begin(), launchers.end(), &Element::less_than);
+	for (std::vector<Launcher*>::size_type i = 0, end = launchers.size(); i < end; ++i)
+	{
+		launchers[i]->set_sort_rank(i);
 	}
 
 	// Sort items and categories
-	if (!wm_settings->load_hierarchy)
+	if (!contents.load_hierarchy)
 	{
-		for (std::vector<Category*>::const_iterator i = m_categories.begin(), end = m_categories.end(); i != end; ++i)
+		for (std::vector<Category*>::const_iterator i = contents.categories.begin(), end = contents.categories.end(); i != end; ++i)
 		{
 			(*i)->sort();
 		}
-		std::sort(m_categories.begin(), m_categories.end(), &Element::less_than);
+		std::sort(contents.categories.begin(), contents.categories.end(), &Element::less_than);
+	}
+
+	// Remove what would be empty rows, before any view asks for the items
+	for (std::vector<Category*>::const_iterator i = contents.categories.begin(), end = contents.categories.end(); i != end; ++i)
+	{
+		(*i)->prune();
 	}
 
-	// Create all items category
+	// Create all items category, which is already in sorted order
 	Category* category = new Category(NULL);
-	for (std::map<std::string, Launcher*>::const_iterator i = m_items.begin(), end = m_items.end(); i != end; ++i)
+	for (std::vector<Launcher*>::const_iterator i = launchers.begin(), end = launchers.end(); i != end; ++i)
+	{
+		category->append_item(*i);
+	}
+	contents.categories.insert(contents.categories.begin(), category);
+}
+
+//-----------------------------------------------------------------------------
+
+void ApplicationsPage::start_loading()
+{
+	// Load into separate contents, keeping the current menu on screen
+	m_load_status = STATUS_LOADING;
+	m_loading = new Contents;
+	m_loaded = false;
+	m_load_thread = g_thread_new("blademenu-menu", &ApplicationsPage::load_thread, this);
+}
+
+//-----------------------------------------------------------------------------
+
+bool ApplicationsPage::finish_loading()
+{
+	g_thread_join(m_load_thread);
+	m_load_thread = NULL;
+	if (m_load_finished_id)
 	{
-		category->append_item(i->second);
+		g_source_remove(m_load_finished_id);
+		m_load_finished_id = 0;
 	}
-	category->sort();
-	m_categories.insert(m_categories.begin(), category);
 
+	Contents* contents = m_loading;
+	m_loading = NULL;
+
+	// Discard menu that was invalidated while loading, or failed to load
+	if (!m_loaded || (m_load_status != STATUS_LOADING))
+	{
+		free_contents(*contents);
+		delete contents;
+		bool invalidated = m_load_status == STATUS_INVALID;
+		m_load_status = STATUS_INVALID;
+		return invalidated;
+	}
+
+	// Replace older menu that was never shown
+	if (m_pending)
+	{
+		free_contents(*m_pending);
+		delete m_pending;
+	}
+	m_pending = contents;
+	m_load_status = STATUS_LOADED;
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
+gpointer ApplicationsPage::load_thread(gpointer data)
+{
+	// Only the new contents are touched here; signals of the loaded menu
+	// are still emitted in the main thread, which owns the default context
+	ApplicationsPage* page = static_cast<ApplicationsPage*>(data);
+	page->m_loaded = page->load_contents(*page->m_loading);
+	page->m_load_finished_id = g_idle_add((GSourceFunc)&ApplicationsPage::load_finished, page);
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+gboolean ApplicationsPage::load_finished(ApplicationsPage* page)
+{
+	bool invalidated = page->finish_loading();
+
+	// Wait to swap menus until the menu is hidden
+	if (page->m_pending && !gtk_widget_get_visible(page->get_window()->get_widget()))
+	{
+		page->show_pending();
+	}
+
+	// Load again if the menu changed while it was being loaded
+	if (invalidated)
+	{
+		page->invalidate_applications();
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
+void ApplicationsPage::show_categories()
+{
 	// Set all applications category
 	get_view()->set_fixed_height_mode(true);
-	get_view()->set_model(category->get_model());
+	get_view()->set_model(m_categories.front()->get_model());
 
 	// Add buttons for categories
 	std::vector<SectionButton*> category_buttons;
@@ -306,13 +733,43 @@ void ApplicationsPage::load_contents()
 
 	// Update menu items of other bars
 	get_window()->set_items();
+}
 
-	m_load_status = STATUS_LOADED;
+//-----------------------------------------------------------------------------
+
+void ApplicationsPage::show_contents()
+{
+	show_categories();
+
+	if (MemoryReport::requested())
+	{
+		MemoryReport report;
+		get_window()->measure(report);
+		report.print();
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void ApplicationsPage::show_pending()
+{
+	// Swap in the menu loaded in the background
+	get_window()->unset_items();
+	get_view()->unset_model();
+
+	Contents previous;
+	swap_contents(previous);
+	swap_contents(*m_pending);
+	delete m_pending;
+	m_pending = NULL;
+	free_contents(previous);
+
+	show_contents();
 }
 
 //-----------------------------------------------------------------------------
 
-void ApplicationsPage::load_menu(PojkMenu* menu, Category* parent_category)
+void ApplicationsPage::load_menu(Contents& contents, PojkMenu* menu, Category* parent_category)
 {
 	PojkMenuDirectory* directory = pojk_menu_get_directory(menu);
 
@@ -323,16 +780,16 @@ void ApplicationsPage::load_menu(PojkMenu* menu, Category* parent_category)
 	}
 
 	// Track categories
-	bool first_level = directory && (pojk_menu_get_parent(menu) == m_pojk_menu);
+	bool first_level = directory && contents.pojk_menu && (pojk_menu_get_parent(menu) == contents.pojk_menu);
 	Category* category = NULL;
 	if (directory)
 	{
 		if (first_level)
 		{
 			category = new Category(directory);
-			m_categories.push_back(category);
+			contents.categories.push_back(category);
 		}
-		else if (!wm_settings->load_hierarchy)
+		else if (!contents.load_hierarchy)
 		{
 			category = parent_category;
 		}
@@ -348,34 +805,38 @@ void ApplicationsPage::load_menu(PojkMenu* menu, Category* parent_category)
 	{
 		if (POJK_IS_MENU_ITEM(li->data))
 		{
-			load_menu_item(POJK_MENU_ITEM(li->data), category);
+			load_menu_item(contents, POJK_MENU_ITEM(li->data), category);
 		}
 		else if (POJK_IS_MENU(li->data))
 		{
-			load_menu(POJK_MENU(li->data), category);
+			load_menu(contents, POJK_MENU(li->data), category);
 		}
-		else if (POJK_IS_MENU_SEPARATOR(li->data) && wm_settings->load_hierarchy && category)
+		else if (POJK_IS_MENU_SEPARATOR(li->data) && contents.load_hierarchy && category)
 		{
 			category->append_separator();
 		}
 	}
 	g_list_free(elements);
 
+	// Listen for menu changes once, as categories can be rebuilt from the
+	// same menu
+	if (!g_signal_handler_find(menu, GSignalMatchType(G_SIGNAL_MATCH_FUNC | G_SIGNAL_MATCH_DATA), 0, 0, NULL, reinterpret_cast<gpointer>(&directory_changed), &m_reload))
+	{
+		g_signal_connect(menu, "directory-changed", G_CALLBACK(&directory_changed), &m_reload);
+	}
+
 	// Free unused top-level categories
 	if (first_level && category->empty())
 	{
-		m_categories.erase(std::find(m_categories.begin(), m_categories.end(), category));
+		contents.categories.erase(std::find(contents.categories.begin(), contents.categories.end(), category));
 		delete category;
 		category = NULL;
 	}
-
-	// Listen for menu changes
-	g_signal_connect_slot<PojkMenu*,PojkMenuDirectory*,PojkMenuDirectory*>(menu, "directory-changed", &ApplicationsPage::invalidate_applications, this);
 }
 
 //-----------------------------------------------------------------------------
 
-void ApplicationsPage::load_menu_item(PojkMenuItem* menu_item, Category* category)
+void ApplicationsPage::load_menu_item(Contents& contents, PojkMenuItem* menu_item, Category* category)
 {
 	// Skip hidden items
 	if (!pojk_menu_element_get_visible(POJK_MENU_ELEMENT(menu_item)))
@@ -385,10 +846,32 @@ void ApplicationsPage::load_menu_item(PojkMenuItem* menu_item, Category* categor
 
 	// Add to map
 	std::string desktop_id(pojk_menu_item_get_desktop_id(menu_item));
-	std::map<std::string, Launcher*>::iterator iter = m_items.find(desktop_id);
-	if (iter == m_items.end())
+	std::map<std::string, Launcher*>::iterator iter = contents.items.find(desktop_id);
+	if (iter == contents.items.end())
 	{
-		iter = m_items.insert(std::make_pair(desktop_id, new Launcher(menu_item))).first;
+		GFile* file = pojk_menu_item_get_file(menu_item);
+		gchar* path = g_file_get_path(file);
+		g_object_unref(file);
+
+		gchar** keywords = NULL;
+		gchar** mime_types = NULL;
+		if (path)
+		{
+			DesktopEntryLoader::read_search_text(path, keywords, mime_types);
+		}
+		Launcher::Text text;
+		Launcher::create_text(menu_item, keywords, mime_types, contents.launcher_options, text);
+		iter = contents.items.insert(std::make_pair(desktop_id, new Launcher(menu_item, contents.dictionary, text))).first;
+		contents.fold_time += text.fold_time;
+		g_strfreev(keywords);
+		g_strfreev(mime_types);
+
+		// Remember file state to filter out notifications without changes
+		ReloadCoordinator::track(contents.files, path);
+		g_free(path);
+
+		// Listen for menu changes
+		g_signal_connect(menu_item, "changed", G_CALLBACK(&item_changed), &m_reload);
 	}
 
 	// Add menu item to current category
@@ -396,9 +879,19 @@ void ApplicationsPage::load_menu_item(PojkMenuItem* menu_item, Category* categor
 	{
 		category->append_item(iter->second);
 	}
+}
+
+//-----------------------------------------------------------------------------
+
+gboolean ApplicationsPage::load_idle(ApplicationsPage* page)
+{
+	page->m_load_idle_id = 0;
+	if ((page->m_load_status == STATUS_INVALID) && !page->m_load_thread)
+	{
+		page->start_loading();
+	}
 
-	// Listen for menu changes
-	g_signal_connect_slot<PojkMenuItem*>(menu_item, "changed", &ApplicationsPage::invalidate_applications, this);
+	return false;
 }
 
 //-----------------------------------------------------------------------------
@@ -18,7 +18,10 @@
 #ifndef BLADEMENU_APPLICATIONS_PAGE_H
 #define BLADEMENU_APPLICATIONS_PAGE_H
 
+#include "launcher.h"
 #include "page.h"
+#include "reload-coordinator.h"
+#include "token-dictionary.h"
 
 #include <map>
 #include <string>
@@ -30,6 +33,7 @@ namespace BladeMenu
 {
 
 class Category;
+class MemoryReport;
 class SectionButton;
 
 class ApplicationsPage : public Page
@@ -44,21 +48,62 @@ public:
 
 	void invalidate_applications();
 	void load_applications();
+	void update_display();
 	void reload_category_icon_size();
+	void measure(MemoryReport& report) const;
 
 private:
+	struct Contents
+	{
+		Contents();
+
+		// Settings are copied, as contents can be loaded in another thread
+		std::string custom_menu_file;
+		bool load_hierarchy;
+		Launcher::Options launcher_options;
+
+		PojkMenu* pojk_menu;
+		PojkMenu* pojk_settings_menu;
+		std::vector<Category*> categories;
+		std::map<std::string, Launcher*> items;
+		TokenDictionary* dictionary;
+		gint64 fold_time;
+		std::vector<GFileMonitor*> monitors;
+		ReloadCoordinator::Files files;
+	};
+
 	void apply_filter(GtkToggleButton* togglebutton);
 	void clear_applications();
-	void load_pojk_menu();
-	void load_contents();
-	void load_menu(PojkMenu* menu, Category* parent_category);
-	void load_menu_item(PojkMenuItem* menu_item, Category* category);
+	void free_contents(Contents& contents);
+	void swap_contents(Contents& contents);
+	bool load_contents(Contents& contents);
+	bool load_desktop_entries(Contents& contents);
+	void load_categories(Contents& contents);
+	void start_loading();
+	bool finish_loading();
+	static gpointer load_thread(gpointer data);
+	static gboolean load_finished(ApplicationsPage* page);
+	void show_categories();
+	void show_contents();
+	void show_pending();
+	void load_menu(Contents& contents, PojkMenu* menu, Category* parent_category);
+	void load_menu_item(Contents& contents, PojkMenuItem* menu_item, Category* category);
+	static gboolean load_idle(ApplicationsPage* page);
 
 private:
 	PojkMenu* m_pojk_menu;
 	PojkMenu* m_pojk_settings_menu;
 	std::vector<Category*> m_categories;
 	std::map<std::string, Launcher*> m_items;
+	TokenDictionary* m_dictionary;
+	std::vector<GFileMonitor*> m_monitors;
+	ReloadCoordinator m_reload;
+	Contents* m_pending;
+	Contents* m_loading;
+	GThread* m_load_thread;
+	guint m_load_finished_id;
+	bool m_loaded;
+	guint m_load_idle_id;
 	int m_load_status;
 };
 
@@ -0,0 +1,372 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "category-model.h"
+
+#include "category.h"
+#include "launcher-view.h"
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+// Tree model that reads rows directly from a category instead of copying
+// them into a store. Iterators hold the category that contains the row in
+// user_data and the index of the row in user_data2.
+
+typedef struct _BladeMenuCategoryModel BladeMenuCategoryModel;
+typedef struct _BladeMenuCategoryModelClass BladeMenuCategoryModelClass;
+
+struct _BladeMenuCategoryModel
+{
+	GObject parent;
+	Category* category;
+	gint stamp;
+};
+
+struct _BladeMenuCategoryModelClass
+{
+	GObjectClass parent_class;
+};
+
+static void blade_menu_category_model_tree_model_init(GtkTreeModelIface* iface);
+
+G_DEFINE_TYPE_WITH_CODE(BladeMenuCategoryModel, blade_menu_category_model, G_TYPE_OBJECT,
+		G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL, blade_menu_category_model_tree_model_init))
+
+#define BLADE_MENU_TYPE_CATEGORY_MODEL (blade_menu_category_model_get_type())
+#define BLADE_MENU_CATEGORY_MODEL(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), BLADE_MENU_TYPE_CATEGORY_MODEL, BladeMenuCategoryModel))
+
+//-----------------------------------------------------------------------------
+
+static bool is_category(const Element* element)
+{
+	return element && (element->get_type() == Category::Type);
+}
+
+//-----------------------------------------------------------------------------
+
+static bool set_iter(BladeMenuCategoryModel* model, GtkTreeIter* iter, Category* category, gint index)
+{
+	if (!category || (index < 0) || (index >= gint(category->get_items().size())))
+	{
+		iter->stamp = 0;
+		return false;
+	}
+
+	iter->stamp = model->stamp;
+	iter->user_data = category;
+	iter->user_data2 = GINT_TO_POINTER(index);
+	iter->user_data3 = NULL;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static Category* iter_category(BladeMenuCategoryModel* model, GtkTreeIter* iter)
+{
+	g_return_val_if_fail(iter->stamp == model->stamp, NULL);
+	return static_cast<Category*>(iter->user_data);
+}
+
+//-----------------------------------------------------------------------------
+
+static Element* iter_element(BladeMenuCategoryModel* model, GtkTreeIter* iter)
+{
+	Category* category = iter_category(model, iter);
+	return category ? category->get_items().at(GPOINTER_TO_INT(iter->user_data2)) : NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+static gint find_index(Category* category)
+{
+	const std::vector<Element*>& items = category->get_parent()->get_items();
+	for (std::vector<Element*>::size_type i = 0, end = items.size(); i < end; ++i)
+	{
+		if (items[i] == category)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+
+static void blade_menu_category_model_class_init(BladeMenuCategoryModelClass*)
+{
+}
+
+//-----------------------------------------------------------------------------
+
+static void blade_menu_category_model_init(BladeMenuCategoryModel* model)
+{
+	model->category = NULL;
+	model->stamp = g_random_int();
+}
+
+//-----------------------------------------------------------------------------
+
+static GtkTreeModelFlags get_flags(GtkTreeModel* tree_model)
+{
+	BladeMenuCategoryModel* model = BLADE_MENU_CATEGORY_MODEL(tree_model);
+	if (model->category && !model->category->has_subcategories())
+	{
+		return GtkTreeModelFlags(GTK_TREE_MODEL_ITERS_PERSIST | GTK_TREE_MODEL_LIST_ONLY);
+	}
+	return GTK_TREE_MODEL_ITERS_PERSIST;
+}
+
+//-----------------------------------------------------------------------------
+
+static gint get_n_columns(GtkTreeModel*)
+{
+	return LauncherView::N_COLUMNS;
+}
+
+//-----------------------------------------------------------------------------
+
+static GType get_column_type(GtkTreeModel*, gint column)
+{
+	return (column == LauncherView::COLUMN_LAUNCHER) ? G_TYPE_POINTER : G_TYPE_STRING;
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean get_iter(GtkTreeModel* tree_model, GtkTreeIter* iter, GtkTreePath* path)
+{
+	BladeMenuCategoryModel* model = BLADE_MENU_CATEGORY_MODEL(tree_model);
+
+	gint depth = gtk_tree_path_get_depth(path);
+	gint* indices = gtk_tree_path_get_indices(path);
+	Category* category = model->category;
+	for (gint i = 0; i < depth; ++i)
+	{
+		if (!set_iter(model, iter, category, indices[i]))
+		{
+			return false;
+		}
+
+		Element* element = category->get_items().at(indices[i]);
+		category = is_category(element) ? static_cast<Category*>(element) : NULL;
+	}
+
+	return depth > 0;
+}
+
+//-----------------------------------------------------------------------------
+
+static GtkTreePath* get_path(GtkTreeModel* tree_model, GtkTreeIter* iter)
+{
+	BladeMenuCategoryModel* model = BLADE_MENU_CATEGORY_MODEL(tree_model);
+
+	Category* category = iter_category(model, iter);
+	g_return_val_if_fail(category, NULL);
+
+	GtkTreePath* path = gtk_tree_path_new();
+	gtk_tree_path_prepend_index(path, GPOINTER_TO_INT(iter->user_data2));
+	for (; category != model->category; category = category->get_parent())
+	{
+		gtk_tree_path_prepend_index(path, find_index(category));
+	}
+	return path;
+}
+
+//-----------------------------------------------------------------------------
+
+static void get_value(GtkTreeModel* tree_model, GtkTreeIter* iter, gint column, GValue* value)
+{
+	BladeMenuCategoryModel* model = BLADE_MENU_CATEGORY_MODEL(tree_model);
+
+	g_value_init(value, get_column_type(tree_model, column));
+
+	Element* element = iter_element(model, iter);
+	if (!element)
+	{
+		// Separators have no values
+		return;
+	}
+
+	if (is_category(element))
+	{
+		Category* category = static_cast<Category*>(element);
+		switch (column)
+		{
+		case LauncherView::COLUMN_ICON:
+			g_value_set_string(value, category->get_model_icon());
+			break;
+
+		case LauncherView::COLUMN_TEXT:
+			g_value_take_string(value, g_markup_escape_text(category->get_text(), -1));
+			break;
+
+		case LauncherView::COLUMN_TOOLTIP:
+			g_value_set_string(value, category->get_tooltip());
+			break;
+
+		default:
+			break;
+		}
+	}
+	else
+	{
+		switch (column)
+		{
+		case LauncherView::COLUMN_ICON:
+			g_value_set_string(value, element->get_icon());
+			break;
+
+		case LauncherView::COLUMN_TEXT:
+			g_value_set_string(value, element->get_text());
+			break;
+
+		case LauncherView::COLUMN_TOOLTIP:
+			g_value_set_string(value, element->get_tooltip());
+			break;
+
+		case LauncherView::COLUMN_LAUNCHER:
+			g_value_set_pointer(value, element);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_next(GtkTreeModel* tree_model, GtkTreeIter* iter)
+{
+	BladeMenuCategoryModel* model = BLADE_MENU_CATEGORY_MODEL(tree_model);
+	return set_iter(model, iter, iter_category(model, iter), GPOINTER_TO_INT(iter->user_data2) + 1);
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_nth_child(GtkTreeModel* tree_model, GtkTreeIter* iter, GtkTreeIter* parent, gint n)
+{
+	BladeMenuCategoryModel* model = BLADE_MENU_CATEGORY_MODEL(tree_model);
+
+	Category* category = model->category;
+	if (parent)
+	{
+		Element* element = iter_element(model, parent);
+		category = is_category(element) ? static_cast<Category*>(element) : NULL;
+	}
+	return set_iter(model, iter, category, n);
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_children(GtkTreeModel* tree_model, GtkTreeIter* iter, GtkTreeIter* parent)
+{
+	return iter_nth_child(tree_model, iter, parent, 0);
+}
+
+//-----------------------------------------------------------------------------
+
+static gint iter_n_children(GtkTreeModel* tree_model, GtkTreeIter* iter)
+{
+	BladeMenuCategoryModel* model = BLADE_MENU_CATEGORY_MODEL(tree_model);
+
+	Category* category = model->category;
+	if (iter)
+	{
+		Element* element = iter_element(model, iter);
+		category = is_category(element) ? static_cast<Category*>(element) : NULL;
+	}
+	return category ? category->get_items().size() : 0;
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_has_child(GtkTreeModel* tree_model, GtkTreeIter* iter)
+{
+	return iter_n_children(tree_model, iter) > 0;
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_parent(GtkTreeModel* tree_model, GtkTreeIter* iter, GtkTreeIter* child)
+{
+	BladeMenuCategoryModel* model = BLADE_MENU_CATEGORY_MODEL(tree_model);
+
+	Category* category = iter_category(model, child);
+	if (!category || (category == model->category))
+	{
+		iter->stamp = 0;
+		return false;
+	}
+	return set_iter(model, iter, category->get_parent(), find_index(category));
+}
+
+//-----------------------------------------------------------------------------
+
+static void blade_menu_category_model_tree_model_init(GtkTreeModelIface* iface)
+{
+	iface->get_flags = get_flags;
+	iface->get_n_columns = get_n_columns;
+	iface->get_column_type = get_column_type;
+	iface->get_iter = get_iter;
+	iface->get_path = get_path;
+	iface->get_value = get_value;
+	iface->iter_next = iter_next;
+	iface->iter_children = iter_children;
+	iface->iter_has_child = iter_has_child;
+	iface->iter_n_children = iter_n_children;
+	iface->iter_nth_child = iter_nth_child;
+	iface->iter_parent = iter_parent;
+}
+
+//-----------------------------------------------------------------------------
+
+GtkTreeModel* CategoryModel::create(Category* category)
+{
+	BladeMenuCategoryModel* model = BLADE_MENU_CATEGORY_MODEL(g_object_new(BLADE_MENU_TYPE_CATEGORY_MODEL, NULL));
+	model->category = category;
+	return GTK_TREE_MODEL(model);
+}
+
+//-----------------------------------------------------------------------------
+
+void CategoryModel::detach(GtkTreeModel* tree_model)
+{
+	// Invalidate outstanding iterators, because the category is going away
+	BladeMenuCategoryModel* model = BLADE_MENU_CATEGORY_MODEL(tree_model);
+	if (!model->category)
+	{
+		return;
+	}
+	gint count = model->category->get_items().size();
+	model->category = NULL;
+	++model->stamp;
+
+	// Tell views that still show the model that its rows are gone, last
+	// first so that the paths of the remaining rows do not change
+	GtkTreePath* path = gtk_tree_path_new();
+	gtk_tree_path_append_index(path, 0);
+	for (gint i = count - 1; i >= 0; --i)
+	{
+		gtk_tree_path_get_indices(path)[0] = i;
+		gtk_tree_model_row_deleted(tree_model, path);
+	}
+	gtk_tree_path_free(path);
+}
+
+//-----------------------------------------------------------------------------
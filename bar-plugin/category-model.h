@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_CATEGORY_MODEL_H
+#define BLADEMENU_CATEGORY_MODEL_H
+
+#include <gtk/gtk.h>
+
+namespace BladeMenu
+{
+
+class Category;
+
+class CategoryModel
+{
+public:
+	static GtkTreeModel* create(Category* category);
+	static void detach(GtkTreeModel* model);
+};
+
+}
+
+#endif // BLADEMENU_CATEGORY_MODEL_H
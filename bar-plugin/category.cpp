@@ -17,7 +17,7 @@
 
 #include "category.h"
 
-#include "launcher-view.h"
+#include "category-model.h"
 #include "section-button.h"
 
 #include <algorithm>
@@ -42,7 +42,9 @@ static bool is_null(const Element* element)
 
 Category::Category(PojkMenuDirectory* directory) :
 	m_button(NULL),
+	m_parent(NULL),
 	m_model(NULL),
+	m_model_icon(NULL),
 	m_has_separators(false),
 	m_has_subcategories(false)
 {
@@ -100,31 +102,30 @@ GtkTreeModel* Category::get_model()
 {
 	if (!m_model)
 	{
-		if (m_has_subcategories)
+		m_model = CategoryModel::create(this);
+	}
+
+	return m_model;
+}
+
+//-----------------------------------------------------------------------------
+
+const gchar* Category::get_model_icon()
+{
+	// Fall back to icon of parent category if icon is missing from theme
+	if (!m_model_icon)
+	{
+		if (!m_parent || gtk_icon_theme_has_icon(gtk_icon_theme_get_default(), get_icon()))
 		{
-			GtkTreeStore* model = gtk_tree_store_new(
-					LauncherView::N_COLUMNS,
-					G_TYPE_STRING,
-					G_TYPE_STRING,
-					G_TYPE_STRING,
-					G_TYPE_POINTER);
-			insert_items(model, NULL, get_icon());
-			m_model = GTK_TREE_MODEL(model);
+			m_model_icon = get_icon();
 		}
 		else
 		{
-			GtkListStore* model = gtk_list_store_new(
-					LauncherView::N_COLUMNS,
-					G_TYPE_STRING,
-					G_TYPE_STRING,
-					G_TYPE_STRING,
-					G_TYPE_POINTER);
-			insert_items(model);
-			m_model = GTK_TREE_MODEL(model);
+			m_model_icon = m_parent->get_model_icon();
 		}
 	}
 
-	return m_model;
+	return m_model_icon;
 }
 
 //-----------------------------------------------------------------------------
@@ -149,6 +150,7 @@ Category* Category::append_menu(PojkMenuDirectory* directory)
 	m_has_subcategories = true;
 	unset_model();
 	Category* category = new Category(directory);
+	category->m_parent = this;
 	m_items.push_back(category);
 	return category;
 }
@@ -167,104 +169,38 @@ void Category::append_separator()
 
 //-----------------------------------------------------------------------------
 
-void Category::sort()
+void Category::measure(MemoryReport& report) const
 {
-	unset_model();
-	merge();
-	if (m_has_separators)
+	// Launchers are shared between categories, so only count the pointers
+	report.add(MemoryReport::Categories, sizeof(Category));
+	Element::measure(report, MemoryReport::Categories);
+	report.add_vector(MemoryReport::Categories, m_items);
+	report.add_model(MemoryReport::Models, m_model);
+	if (m_button)
 	{
-		m_items.erase(std::remove_if(m_items.begin(), m_items.end(), is_null), m_items.end());
+		report.add_object(MemoryReport::Categories, m_button->get_button());
 	}
-	std::sort(m_items.begin(), m_items.end(), &Element::less_than);
-}
 
-//-----------------------------------------------------------------------------
-
-void Category::insert_items(GtkTreeStore* model, GtkTreeIter* parent, const gchar* fallback_icon)
-{
-	for (std::vector<Element*>::size_type i = 0, end = m_items.size(); i < end; ++i)
+	for (std::vector<Element*>::const_iterator i = m_items.begin(), end = m_items.end(); i != end; ++i)
 	{
-		Element* element = m_items.at(i);
-		if (is_category(element))
-		{
-			Category* category = static_cast<Category*>(element);
-			if (category->empty())
-			{
-				continue;
-			}
-
-			const gchar* icon = category->get_icon();
-			if (!gtk_icon_theme_has_icon(gtk_icon_theme_get_default(), icon))
-			{
-				icon = fallback_icon;
-			}
-			gchar* text = g_markup_escape_text(category->get_text(), -1);
-			const gchar* tooltip = category->get_tooltip();
-
-			GtkTreeIter iter;
-			gtk_tree_store_insert_with_values(model,
-					&iter, parent, INT_MAX,
-					LauncherView::COLUMN_ICON, icon,
-					LauncherView::COLUMN_TEXT, text,
-					LauncherView::COLUMN_TOOLTIP, tooltip,
-					LauncherView::COLUMN_LAUNCHER, NULL,
-					-1);
-			g_free(text);
-			category->insert_items(model, &iter, icon);
-		}
-		else if (element)
-		{
-			Launcher* launcher = static_cast<Launcher*>(element);
-			gtk_tree_store_insert_with_values(model,
-					NULL, parent, INT_MAX,
-					LauncherView::COLUMN_ICON, launcher->get_icon(),
-					LauncherView::COLUMN_TEXT, launcher->get_text(),
-					LauncherView::COLUMN_TOOLTIP, launcher->get_tooltip(),
-					LauncherView::COLUMN_LAUNCHER, launcher,
-					-1);
-		}
-		else if ((i + 1) < end)
+		if (is_category(*i))
 		{
-			gtk_tree_store_insert_with_values(model,
-					NULL, parent, INT_MAX,
-					LauncherView::COLUMN_ICON, NULL,
-					LauncherView::COLUMN_TEXT, NULL,
-					LauncherView::COLUMN_TOOLTIP, NULL,
-					LauncherView::COLUMN_LAUNCHER, NULL,
-					-1);
+			static_cast<Category*>(*i)->measure(report);
 		}
 	}
 }
 
 //-----------------------------------------------------------------------------
 
-void Category::insert_items(GtkListStore* model)
+void Category::sort()
 {
-	for (std::vector<Element*>::size_type i = 0, end = m_items.size(); i < end; ++i)
+	unset_model();
+	merge();
+	if (m_has_separators)
 	{
-		Element* element = m_items.at(i);
-		if (element)
-		{
-			Launcher* launcher = static_cast<Launcher*>(element);
-			gtk_list_store_insert_with_values(model,
-					NULL, INT_MAX,
-					LauncherView::COLUMN_ICON, launcher->get_icon(),
-					LauncherView::COLUMN_TEXT, launcher->get_text(),
-					LauncherView::COLUMN_TOOLTIP, launcher->get_tooltip(),
-					LauncherView::COLUMN_LAUNCHER, launcher,
-					-1);
-		}
-		else if ((i + 1) < end)
-		{
-			gtk_list_store_insert_with_values(model,
-					NULL, INT_MAX,
-					LauncherView::COLUMN_ICON, NULL,
-					LauncherView::COLUMN_TEXT, NULL,
-					LauncherView::COLUMN_TOOLTIP, NULL,
-					LauncherView::COLUMN_LAUNCHER, NULL,
-					-1);
-		}
+		m_items.erase(std::remove_if(m_items.begin(), m_items.end(), is_null), m_items.end());
 	}
+	std::sort(m_items.begin(), m_items.end(), &Element::less_than_rank);
 }
 
 //-----------------------------------------------------------------------------
@@ -331,10 +267,47 @@ void Category::merge()
 
 //-----------------------------------------------------------------------------
 
+void Category::prune()
+{
+	// Remove a trailing separator and empty subcategories once the category
+	// is built, so that every item is shown as a row in the model
+	unset_model();
+	if (!m_items.empty() && !m_items.back())
+	{
+		m_items.pop_back();
+	}
+
+	std::vector<Element*>::iterator last = m_items.begin();
+	for (std::vector<Element*>::iterator i = m_items.begin(), end = m_items.end(); i != end; ++i)
+	{
+		Element* element = *i;
+		if (is_category(element))
+		{
+			Category* category = static_cast<Category*>(element);
+			if (category->empty())
+			{
+				delete category;
+				continue;
+			}
+			category->prune();
+		}
+		*last = element;
+		++last;
+	}
+	m_items.erase(last, m_items.end());
+
+	m_has_subcategories = std::find_if(m_items.begin(), m_items.end(), is_category) != m_items.end();
+}
+
+//-----------------------------------------------------------------------------
+
 void Category::unset_model()
 {
+	m_model_icon = NULL;
+
 	if (m_model)
 	{
+		CategoryModel::detach(m_model);
 		g_object_unref(m_model);
 		m_model = NULL;
 	}
@@ -56,6 +56,23 @@ public:
 		return m_has_separators;
 	}
 
+	bool has_subcategories() const
+	{
+		return m_has_subcategories;
+	}
+
+	const std::vector<Element*>& get_items() const
+	{
+		return m_items;
+	}
+
+	Category* get_parent() const
+	{
+		return m_parent;
+	}
+
+	const gchar* get_model_icon();
+
 	void append_item(Launcher* launcher)
 	{
 		unset_model();
@@ -66,18 +83,22 @@ public:
 
 	void append_separator();
 
+	void measure(MemoryReport& report) const;
+
+	void prune();
+
 	void sort();
 
 private:
-	void insert_items(GtkTreeStore* model, GtkTreeIter* parent, const gchar* fallback_icon);
-	void insert_items(GtkListStore* model);
 	void merge();
 	void unset_model();
 
 private:
 	SectionButton* m_button;
+	Category* m_parent;
 	std::vector<Element*> m_items;
 	GtkTreeModel* m_model;
+	const gchar* m_model_icon;
 	bool m_has_separators;
 	bool m_has_subcategories;
 };
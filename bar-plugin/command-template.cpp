@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "command-template.h"
+
+#include <cstring>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+CommandTemplate::CommandTemplate(const gchar* command) :
+	m_length(0),
+	m_fields(0)
+{
+	set(command);
+}
+
+//-----------------------------------------------------------------------------
+
+void CommandTemplate::expand(const gchar* const values[CountFields], std::string& command) const
+{
+	command.clear();
+	command.reserve(m_length);
+
+	for (std::vector<Segment>::const_iterator i = m_segments.begin(), end = m_segments.end(); i != end; ++i)
+	{
+		if (i->field == -1)
+		{
+			command.append(m_literals, i->offset, i->length);
+		}
+		else if (values[i->field])
+		{
+			command += values[i->field];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void CommandTemplate::set(const gchar* command)
+{
+	m_segments.clear();
+	m_literals.clear();
+	m_length = 0;
+	m_fields = 0;
+
+	if (!command)
+	{
+		return;
+	}
+
+	// Split the field codes from the text around them; a trailing percent
+	// sign is kept as text, and unknown field codes are removed
+	const gchar* start = command;
+	for (const gchar* pos = command; *pos; ++pos)
+	{
+		if ((*pos != '%') || (pos[1] == '\0'))
+		{
+			continue;
+		}
+
+		append_literal(start, pos - start);
+		++pos;
+		switch (*pos)
+		{
+		case 's':
+			append_field(FieldText);
+			break;
+
+		case 'S':
+			append_field(FieldRawText);
+			break;
+
+		case 'u':
+			append_field(FieldUri);
+			break;
+
+		case 'i':
+			append_field(FieldIcon);
+			break;
+
+		case 'c':
+			append_field(FieldName);
+			break;
+
+		case 'k':
+			append_field(FieldLocation);
+			break;
+
+		case '%':
+			append_literal(pos, 1);
+			break;
+
+		default:
+			break;
+		}
+		start = pos + 1;
+	}
+	append_literal(start, strlen(start));
+}
+
+//-----------------------------------------------------------------------------
+
+void CommandTemplate::append_literal(const gchar* text, gsize length)
+{
+	if (!length)
+	{
+		return;
+	}
+
+	m_length += length;
+
+	// Merge adjacent text, such as around an escaped percent sign
+	if (!m_segments.empty() && (m_segments.back().field == -1))
+	{
+		m_segments.back().length += length;
+		m_literals.append(text, length);
+		return;
+	}
+
+	Segment segment;
+	segment.field = -1;
+	segment.offset = m_literals.length();
+	segment.length = length;
+	m_segments.push_back(segment);
+	m_literals.append(text, length);
+}
+
+//-----------------------------------------------------------------------------
+
+void CommandTemplate::append_field(Field field)
+{
+	Segment segment;
+	segment.field = field;
+	segment.offset = 0;
+	segment.length = 0;
+	m_segments.push_back(segment);
+	m_fields |= (1 << field);
+}
+
+//-----------------------------------------------------------------------------
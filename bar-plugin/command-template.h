@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_COMMAND_TEMPLATE_H
+#define BLADEMENU_COMMAND_TEMPLATE_H
+
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+namespace BladeMenu
+{
+
+class CommandTemplate
+{
+public:
+	explicit CommandTemplate(const gchar* command = NULL);
+
+	enum Field
+	{
+		FieldText = 0,
+		FieldRawText,
+		FieldUri,
+		FieldIcon,
+		FieldName,
+		FieldLocation,
+		CountFields
+	};
+
+	bool empty() const
+	{
+		return m_segments.empty();
+	}
+
+	bool has_field(Field field) const
+	{
+		return m_fields & (1 << field);
+	}
+
+	void expand(const gchar* const values[CountFields], std::string& command) const;
+	void set(const gchar* command);
+
+private:
+	void append_literal(const gchar* text, gsize length);
+	void append_field(Field field);
+
+private:
+	struct Segment
+	{
+		int field;
+		std::string::size_type offset;
+		std::string::size_type length;
+	};
+	std::vector<Segment> m_segments;
+	std::string m_literals;
+	std::string::size_type m_length;
+	unsigned int m_fields;
+};
+
+}
+
+#endif // BLADEMENU_COMMAND_TEMPLATE_H
@@ -19,6 +19,7 @@
 
 #include "settings.h"
 #include "slot.h"
+#include "spawner.h"
 
 #include <string>
 
@@ -173,7 +174,7 @@ void Command::check()
 		gchar** argv;
 		if (g_shell_parse_argv(m_command, NULL, &argv, NULL))
 		{
-			gchar* path = g_find_program_in_path(argv[0]);
+			gchar* path = Spawner::find_program(argv[0]);
 			m_status = path ? BLADEMENU_COMMAND_VALID : BLADEMENU_COMMAND_INVALID;
 			g_free(path);
 			g_strfreev(argv);
@@ -201,7 +202,7 @@ void Command::check()
 void Command::activate()
 {
 	GError* error = NULL;
-	if (g_spawn_command_line_async(m_command, &error) == false)
+	if (Spawner::run(NULL, m_command, &error) == false)
 	{
 		xfce_dialog_show_error(NULL, error, m_error_text, NULL);
 		g_error_free(error);
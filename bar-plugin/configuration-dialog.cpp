@@ -196,20 +196,28 @@ void ConfigurationDialog::toggle_hover_switch_category(GtkToggleButton* button)
 
 //-----------------------------------------------------------------------------
 
+void ConfigurationDialog::toggle_launcher_prefetch(GtkToggleButton* button)
+{
+	wm_settings->launcher_prefetch = gtk_toggle_button_get_active(button);
+	wm_settings->set_modified();
+}
+
+//-----------------------------------------------------------------------------
+
 void ConfigurationDialog::toggle_show_generic_name(GtkToggleButton* button)
 {
 	wm_settings->launcher_show_name = !gtk_toggle_button_get_active(button);
 	wm_settings->set_modified();
-	m_plugin->reload();
+	m_plugin->update_display();
 }
 
 //-----------------------------------------------------------------------------
 
 void ConfigurationDialog::toggle_show_category_name(GtkToggleButton* button)
 {
+	// Category buttons are laid out again when the menu is next shown
 	wm_settings->category_show_name = gtk_toggle_button_get_active(button);
 	wm_settings->set_modified();
-	m_plugin->reload();
 }
 
 //-----------------------------------------------------------------------------
@@ -218,7 +226,7 @@ void ConfigurationDialog::toggle_show_description(GtkToggleButton* button)
 {
 	wm_settings->launcher_show_description = gtk_toggle_button_get_active(button);
 	wm_settings->set_modified();
-	m_plugin->reload();
+	m_plugin->update_display();
 }
 
 //-----------------------------------------------------------------------------
@@ -235,7 +243,7 @@ void ConfigurationDialog::toggle_show_hierarchy(GtkToggleButton* button)
 {
 	wm_settings->load_hierarchy = gtk_toggle_button_get_active(button);
 	wm_settings->set_modified();
-	m_plugin->reload();
+	m_plugin->update_display();
 }
 
 //-----------------------------------------------------------------------------
@@ -692,6 +700,12 @@ GtkWidget* ConfigurationDialog::init_behavior_tab()
 	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(m_hover_switch_category), wm_settings->category_hover_activate);
 	g_signal_connect_slot(m_hover_switch_category, "toggled", &ConfigurationDialog::toggle_hover_switch_category, this);
 
+	// Add option to prefetch frequently used applications
+	m_launcher_prefetch = gtk_check_button_new_with_mnemonic(_("_Prefetch selected favorite and recent applications"));
+	gtk_box_pack_start(behavior_vbox, m_launcher_prefetch, true, true, 0);
+	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(m_launcher_prefetch), wm_settings->launcher_prefetch);
+	g_signal_connect_slot(m_launcher_prefetch, "toggled", &ConfigurationDialog::toggle_launcher_prefetch, this);
+
 	// Add option to use alternate search entry position
 	m_position_search_alternate = gtk_check_button_new_with_mnemonic(_("Position _search entry next to bar button"));
 	gtk_box_pack_start(behavior_vbox, m_position_search_alternate, true, true, 0);
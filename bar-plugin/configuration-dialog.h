@@ -58,6 +58,7 @@ private:
 
 	void toggle_button_single_row(GtkToggleButton* button);
 	void toggle_hover_switch_category(GtkToggleButton* button);
+	void toggle_launcher_prefetch(GtkToggleButton* button);
 
 	void recent_items_max_changed(GtkSpinButton* button);
 	void toggle_remember_favorites(GtkToggleButton* button);
@@ -103,6 +104,7 @@ private:
 	GtkWidget* m_icon_button;
 
 	GtkWidget* m_hover_switch_category;
+	GtkWidget* m_launcher_prefetch;
 	GtkWidget* m_remember_favorites;
 	GtkWidget* m_display_recent;
 	GtkWidget* m_recent_items_max;
@@ -0,0 +1,862 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "desktop-entry-loader.h"
+
+#include "settings.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+// Most threads used to read desktop entries
+static const guint max_threads = 8;
+
+//-----------------------------------------------------------------------------
+
+// Categories of the default applications menu, which is what the flat menu
+// shows; launchers in none of them are placed in the last one. Only the
+// <Include> categories of the menu file are matched: its <Exclude> rules,
+// such as the ones keeping settings dialogs out of the accessories, are not
+// applied, so a launcher can show in more categories than with the menu.
+static const struct
+{
+	const gchar* directory;
+	const gchar* categories;
+}
+menu_directories[] =
+{
+	{ "xfce-accessories.directory", "Accessibility;Core;Legacy;Utility;" },
+	{ "xfce-development.directory", "Development;" },
+	{ "xfce-education.directory", "Education;" },
+	{ "xfce-games.directory", "Game;" },
+	{ "xfce-graphics.directory", "Graphics;" },
+	{ "xfce-multimedia.directory", "Audio;Video;AudioVideo;" },
+	{ "xfce-network.directory", "Network;" },
+	{ "xfce-office.directory", "Office;" },
+	{ "xfce-settings.directory", "Settings;DesktopSettings;HardwareSettings;" },
+	{ "xfce-system.directory", "Emulator;System;" },
+	{ "xfce-other.directory", "" }
+};
+static const guint count_menu_directories = G_N_ELEMENTS(menu_directories);
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// Value of a key in a mapped file, which is not copied or terminated
+struct Value
+{
+	Value() :
+		data(NULL),
+		length(0)
+	{
+	}
+
+	bool empty() const
+	{
+		return !data;
+	}
+
+	bool is_true() const
+	{
+		return (length == 4) && (strncmp(data, "true", 4) == 0);
+	}
+
+	bool equals(const gchar* string) const
+	{
+		return (length == strlen(string)) && (strncmp(data, string, length) == 0);
+	}
+
+	bool contains(const gchar* item, gsize item_length) const
+	{
+		// Check each item of a semicolon separated list
+		const gchar* end = data + length;
+		for (const gchar* pos = data; pos < end;)
+		{
+			const gchar* next = static_cast<const gchar*>(memchr(pos, ';', end - pos));
+			if (!next)
+			{
+				next = end;
+			}
+			if ((gsize(next - pos) == item_length) && (strncmp(pos, item, item_length) == 0))
+			{
+				return true;
+			}
+			pos = next + 1;
+		}
+		return false;
+	}
+
+	const gchar* data;
+	gsize length;
+};
+
+// Keys of the desktop entry group that decide if and where it is shown,
+// and the search text that menu items do not provide
+struct Keys
+{
+	Keys() :
+		languages(NULL),
+		keywords_rank(G_MAXUINT)
+	{
+	}
+
+	Value type;
+	Value hidden;
+	Value no_display;
+	Value only_show_in;
+	Value not_show_in;
+	Value try_exec;
+	Value categories;
+
+	// Localized keywords are only looked for if languages are set
+	const gchar* const* languages;
+	Value keywords;
+	guint keywords_rank;
+	Value mime_type;
+};
+
+}
+
+//-----------------------------------------------------------------------------
+
+static void scan(const gchar* contents, gsize length, Keys& keys)
+{
+	bool in_group = false;
+	const gchar* end = contents + length;
+	for (const gchar* line = contents; line < end;)
+	{
+		const gchar* line_end = static_cast<const gchar*>(memchr(line, '\n', end - line));
+		if (!line_end)
+		{
+			line_end = end;
+		}
+		const gchar* next = line_end + 1;
+
+		// Strip trailing whitespace
+		while ((line_end > line) && g_ascii_isspace(line_end[-1]))
+		{
+			--line_end;
+		}
+
+		if ((line == line_end) || (*line == '#'))
+		{
+			line = next;
+			continue;
+		}
+
+		// Only read the main group, which comes first
+		if (*line == '[')
+		{
+			if (in_group)
+			{
+				break;
+			}
+			in_group = (line_end - line == 15) && (strncmp(line, "[Desktop Entry]", 15) == 0);
+			line = next;
+			continue;
+		}
+
+		const gchar* equals = static_cast<const gchar*>(memchr(line, '=', line_end - line));
+		if (!in_group || !equals)
+		{
+			line = next;
+			continue;
+		}
+
+		const gchar* key_end = equals;
+		while ((key_end > line) && g_ascii_isspace(key_end[-1]))
+		{
+			--key_end;
+		}
+		const gchar* value = equals + 1;
+		while ((value < line_end) && g_ascii_isspace(*value))
+		{
+			++value;
+		}
+
+		Value* found = NULL;
+		const gsize key_length = key_end - line;
+		if (keys.languages && (key_length > 10) && (key_end[-1] == ']') && (strncmp(line, "Keywords[", 9) == 0))
+		{
+			// Prefer the locale that comes first in the language names
+			const gsize locale_length = key_length - 10;
+			for (guint i = 0; keys.languages[i] && (i < keys.keywords_rank); ++i)
+			{
+				if ((strlen(keys.languages[i]) == locale_length) && (strncmp(line + 9, keys.languages[i], locale_length) == 0))
+				{
+					keys.keywords_rank = i;
+					keys.keywords.data = value;
+					keys.keywords.length = line_end - value;
+					break;
+				}
+			}
+			line = next;
+			continue;
+		}
+
+		switch (key_length)
+		{
+		case 4:
+			if (strncmp(line, "Type", 4) == 0)
+			{
+				found = &keys.type;
+			}
+			break;
+
+		case 6:
+			if (strncmp(line, "Hidden", 6) == 0)
+			{
+				found = &keys.hidden;
+			}
+			break;
+
+		case 7:
+			if (strncmp(line, "TryExec", 7) == 0)
+			{
+				found = &keys.try_exec;
+			}
+			break;
+
+		case 8:
+			if (keys.languages && (strncmp(line, "Keywords", 8) == 0) && (keys.keywords_rank == G_MAXUINT))
+			{
+				found = &keys.keywords;
+			}
+			else if (keys.languages && (strncmp(line, "MimeType", 8) == 0))
+			{
+				found = &keys.mime_type;
+			}
+			break;
+
+		case 9:
+			if (strncmp(line, "NoDisplay", 9) == 0)
+			{
+				found = &keys.no_display;
+			}
+			else if (strncmp(line, "NotShowIn", 9) == 0)
+			{
+				found = &keys.not_show_in;
+			}
+			break;
+
+		case 10:
+			if (strncmp(line, "OnlyShowIn", 10) == 0)
+			{
+				found = &keys.only_show_in;
+			}
+			else if (strncmp(line, "Categories", 10) == 0)
+			{
+				found = &keys.categories;
+			}
+			break;
+
+		default:
+			break;
+		}
+
+		if (found)
+		{
+			found->data = value;
+			found->length = line_end - value;
+		}
+
+		line = next;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+static bool try_exec(const Value& value)
+{
+	gchar* program = g_strndup(value.data, value.length);
+	bool found = false;
+	if (g_path_is_absolute(program))
+	{
+		found = g_file_test(program, G_FILE_TEST_IS_EXECUTABLE);
+	}
+	else
+	{
+		gchar* path = g_find_program_in_path(program);
+		found = path != NULL;
+		g_free(path);
+	}
+	g_free(program);
+	return found;
+}
+
+//-----------------------------------------------------------------------------
+
+static gchar** split_list(const Value& value)
+{
+	if (value.empty())
+	{
+		return NULL;
+	}
+
+	// Unescape items of a semicolon separated list, as GKeyFile does
+	GPtrArray* items = g_ptr_array_new();
+	GString* item = g_string_new(NULL);
+	const gchar* end = value.data + value.length;
+	for (const gchar* pos = value.data; pos < end; ++pos)
+	{
+		if ((*pos == '\\') && (pos + 1 < end))
+		{
+			++pos;
+			switch (*pos)
+			{
+			case 's':
+				g_string_append_c(item, ' ');
+				break;
+
+			case 'n':
+				g_string_append_c(item, '\n');
+				break;
+
+			case 't':
+				g_string_append_c(item, '\t');
+				break;
+
+			case 'r':
+				g_string_append_c(item, '\r');
+				break;
+
+			default:
+				g_string_append_c(item, *pos);
+				break;
+			}
+		}
+		else if (*pos == ';')
+		{
+			g_ptr_array_add(items, g_string_free(item, false));
+			item = g_string_new(NULL);
+		}
+		else
+		{
+			g_string_append_c(item, *pos);
+		}
+	}
+	if (item->len)
+	{
+		g_ptr_array_add(items, g_string_free(item, false));
+	}
+	else
+	{
+		g_string_free(item, true);
+	}
+	g_ptr_array_add(items, NULL);
+
+	return reinterpret_cast<gchar**>(g_ptr_array_free(items, false));
+}
+
+//-----------------------------------------------------------------------------
+
+// Each worker has its own queue of folders and files, taking the newest
+// from it and taking the oldest from other workers when it runs out
+class DesktopEntryLoader::Worker
+{
+public:
+	explicit Worker(DesktopEntryLoader* loader) :
+		loader(loader),
+		thread(NULL)
+	{
+		g_mutex_init(&mutex);
+	}
+
+	~Worker()
+	{
+		g_mutex_clear(&mutex);
+	}
+
+	void push(const Task& task)
+	{
+		g_atomic_int_inc(&loader->m_pending);
+		g_mutex_lock(&mutex);
+		tasks.push_back(task);
+		g_mutex_unlock(&mutex);
+		g_atomic_int_inc(&loader->m_queued);
+		loader->wake_workers();
+	}
+
+	bool pop(Task& task)
+	{
+		g_mutex_lock(&mutex);
+		bool found = !tasks.empty();
+		if (found)
+		{
+			task = tasks.back();
+			tasks.pop_back();
+			g_atomic_int_add(&loader->m_queued, -1);
+		}
+		g_mutex_unlock(&mutex);
+		return found;
+	}
+
+	bool steal(Task& task)
+	{
+		g_mutex_lock(&mutex);
+		bool found = !tasks.empty();
+		if (found)
+		{
+			task = tasks.front();
+			tasks.pop_front();
+			g_atomic_int_add(&loader->m_queued, -1);
+		}
+		g_mutex_unlock(&mutex);
+		return found;
+	}
+
+	DesktopEntryLoader* loader;
+	GThread* thread;
+	GMutex mutex;
+	std::deque<Task> tasks;
+	std::vector<Result> results;
+	std::vector<std::pair<guint, std::string> > folders;
+};
+
+//-----------------------------------------------------------------------------
+
+bool DesktopEntryLoader::Result::less_than(const Result& lhs, const Result& rhs)
+{
+	// Order by id and then by priority, so that the first of each id wins
+	int compare = lhs.entry.desktop_id.compare(rhs.entry.desktop_id);
+	if (compare)
+	{
+		return compare < 0;
+	}
+	if (lhs.base != rhs.base)
+	{
+		return lhs.base < rhs.base;
+	}
+	return lhs.entry.path < rhs.entry.path;
+}
+
+//-----------------------------------------------------------------------------
+
+DesktopEntryLoader::DesktopEntryLoader(const Launcher::Options& options) :
+	m_options(options),
+	m_environment(pojk_get_environment()),
+	m_pending(0),
+	m_queued(0)
+{
+	g_mutex_init(&m_idle_mutex);
+	g_cond_init(&m_idle_cond);
+}
+
+//-----------------------------------------------------------------------------
+
+DesktopEntryLoader::~DesktopEntryLoader()
+{
+	for (std::vector<Entry>::iterator i = m_entries.begin(), end = m_entries.end(); i != end; ++i)
+	{
+		free_entry(*i);
+	}
+
+	g_cond_clear(&m_idle_cond);
+	g_mutex_clear(&m_idle_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
+bool DesktopEntryLoader::enabled()
+{
+	return g_getenv("BLADEMENU_NATIVE_LOADER");
+}
+
+//-----------------------------------------------------------------------------
+
+void DesktopEntryLoader::read_search_text(const gchar* path, gchar**& keywords, gchar**& mime_types)
+{
+	// Menu items loaded by pojk do not keep the keys needed for searching,
+	// so only scan for those instead of parsing the whole file again
+	keywords = NULL;
+	mime_types = NULL;
+
+	GMappedFile* file = g_mapped_file_new(path, false, NULL);
+	if (!file)
+	{
+		return;
+	}
+
+	Keys keys;
+	keys.languages = g_get_language_names();
+	scan(g_mapped_file_get_contents(file), g_mapped_file_get_length(file), keys);
+	keywords = split_list(keys.keywords);
+	mime_types = split_list(keys.mime_type);
+
+	g_mapped_file_unref(file);
+}
+
+//-----------------------------------------------------------------------------
+
+void DesktopEntryLoader::load()
+{
+	for (guint i = 0; i < count_menu_directories; ++i)
+	{
+		gchar* path = g_build_filename("desktop-directories", menu_directories[i].directory, NULL);
+		gchar* file = xfce_resource_lookup(XFCE_RESOURCE_DATA, path);
+		m_directories.push_back(file ? file : "");
+		g_free(file);
+		g_free(path);
+	}
+
+	// Create workers; a single worker reads everything in this thread
+	guint count = CLAMP(g_get_num_processors(), 1, max_threads);
+	for (guint i = 0; i < count; ++i)
+	{
+		m_workers.push_back(new Worker(this));
+	}
+
+	// Spread application folders over the workers, user folder first
+	// because its entries hide system entries with the same id
+	std::vector<std::string> folders;
+	gchar* folder = g_build_filename(g_get_user_data_dir(), "applications", NULL);
+	folders.push_back(folder);
+	g_free(folder);
+	for (const gchar* const* dir = g_get_system_data_dirs(); *dir; ++dir)
+	{
+		folder = g_build_filename(*dir, "applications", NULL);
+		folders.push_back(folder);
+		g_free(folder);
+	}
+	for (std::vector<std::string>::size_type i = 0, end = folders.size(); i < end; ++i)
+	{
+		Task task = { folders[i], std::string(), guint(i), true };
+		m_workers[i % count]->push(task);
+	}
+
+	for (guint i = 1; i < count; ++i)
+	{
+		m_workers[i]->thread = g_thread_new("blademenu-loader", &DesktopEntryLoader::run_thread, m_workers[i]);
+	}
+	run(m_workers[0]);
+
+	// Merge results in an order that does not depend on the threads
+	std::vector<Result> results;
+	std::vector<std::pair<guint, std::string> > loaded_folders;
+	for (std::vector<Worker*>::const_iterator i = m_workers.begin(), end = m_workers.end(); i != end; ++i)
+	{
+		if ((*i)->thread)
+		{
+			g_thread_join((*i)->thread);
+		}
+		results.insert(results.end(), (*i)->results.begin(), (*i)->results.end());
+		loaded_folders.insert(loaded_folders.end(), (*i)->folders.begin(), (*i)->folders.end());
+		delete *i;
+	}
+	m_workers.clear();
+
+	std::sort(results.begin(), results.end(), &Result::less_than);
+	for (std::vector<Result>::iterator i = results.begin(), end = results.end(); i != end; ++i)
+	{
+		// Entries hide later entries with the same id even if not shown
+		bool hidden = (i != results.begin()) && ((i - 1)->entry.desktop_id == i->entry.desktop_id);
+		if (!hidden && i->entry.menu_item)
+		{
+			m_entries.push_back(i->entry);
+		}
+		else
+		{
+			free_entry(i->entry);
+		}
+	}
+
+	std::sort(loaded_folders.begin(), loaded_folders.end());
+	for (std::vector<std::pair<guint, std::string> >::const_iterator i = loaded_folders.begin(), end = loaded_folders.end(); i != end; ++i)
+	{
+		m_folders.push_back(i->second);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void DesktopEntryLoader::run(Worker* worker)
+{
+	Task task;
+	for (;;)
+	{
+		// Take own work first, and then the oldest work of other workers
+		bool found = worker->pop(task);
+		for (std::vector<Worker*>::const_iterator i = m_workers.begin(), end = m_workers.end(); !found && (i != end); ++i)
+		{
+			found = (*i != worker) && (*i)->steal(task);
+		}
+
+		if (!found)
+		{
+			// Sleep until a task is queued or the last task is finished,
+			// since other workers may still add folder contents
+			g_mutex_lock(&m_idle_mutex);
+			while (!g_atomic_int_get(&m_queued) && g_atomic_int_get(&m_pending))
+			{
+				g_cond_wait(&m_idle_cond, &m_idle_mutex);
+			}
+			g_mutex_unlock(&m_idle_mutex);
+
+			if (!g_atomic_int_get(&m_pending))
+			{
+				break;
+			}
+			continue;
+		}
+
+		if (task.folder)
+		{
+			load_folder(worker, task);
+		}
+		else
+		{
+			load_entry(worker, task);
+		}
+		if (g_atomic_int_dec_and_test(&m_pending))
+		{
+			wake_workers();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void DesktopEntryLoader::wake_workers()
+{
+	// Taking the lock makes sure that a worker about to sleep sees the
+	// change or is already waiting for it
+	g_mutex_lock(&m_idle_mutex);
+	g_cond_broadcast(&m_idle_cond);
+	g_mutex_unlock(&m_idle_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
+gpointer DesktopEntryLoader::run_thread(gpointer data)
+{
+	Worker* worker = static_cast<Worker*>(data);
+	worker->loader->run(worker);
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+void DesktopEntryLoader::load_folder(Worker* worker, const Task& task)
+{
+	GDir* dir = g_dir_open(task.path.c_str(), 0, NULL);
+	if (!dir)
+	{
+		return;
+	}
+
+	worker->folders.push_back(std::make_pair(task.base, task.path));
+
+	// Desktop ids of files in subfolders are prefixed by the subfolders
+	while (const gchar* name = g_dir_read_name(dir))
+	{
+		gchar* path = g_build_filename(task.path.c_str(), name, NULL);
+		if (g_str_has_suffix(name, ".desktop"))
+		{
+			Task entry = { path, task.desktop_id + name, task.base, false };
+			worker->push(entry);
+		}
+		else if (g_file_test(path, G_FILE_TEST_IS_DIR))
+		{
+			Task subfolder = { path, task.desktop_id + name + "-", task.base, true };
+			worker->push(subfolder);
+		}
+		g_free(path);
+	}
+	g_dir_close(dir);
+}
+
+//-----------------------------------------------------------------------------
+
+void DesktopEntryLoader::load_entry(Worker* worker, const Task& task)
+{
+	// Entries that are not shown are still kept to hide later entries
+	Result result = { task.base, { task.desktop_id, task.path, NULL, NULL, 0 } };
+
+	GMappedFile* file = g_mapped_file_new(task.path.c_str(), false, NULL);
+	if (!file)
+	{
+		worker->results.push_back(result);
+		return;
+	}
+
+	Keys keys;
+	scan(g_mapped_file_get_contents(file), g_mapped_file_get_length(file), keys);
+
+	// Apply the same rules as the menu for hiding entries
+	bool visible = keys.type.equals("Application")
+			&& !keys.hidden.is_true()
+			&& !keys.no_display.is_true();
+	if (visible && m_environment)
+	{
+		const gsize length = strlen(m_environment);
+		if (!keys.only_show_in.empty())
+		{
+			visible = keys.only_show_in.contains(m_environment, length);
+		}
+		else if (!keys.not_show_in.empty())
+		{
+			visible = !keys.not_show_in.contains(m_environment, length);
+		}
+	}
+	if (visible && !keys.try_exec.empty())
+	{
+		visible = try_exec(keys.try_exec);
+	}
+
+	if (visible)
+	{
+		// Find categories of the default menu that include this entry
+		Entry& entry = result.entry;
+		for (guint i = 0; i < count_menu_directories - 1; ++i)
+		{
+			for (const gchar* category = menu_directories[i].categories; *category;)
+			{
+				const gchar* category_end = strchr(category, ';');
+				if (keys.categories.contains(category, category_end - category))
+				{
+					entry.directories |= 1 << i;
+					break;
+				}
+				category = category_end + 1;
+			}
+		}
+		if (!entry.directories)
+		{
+			entry.directories = 1 << (count_menu_directories - 1);
+		}
+
+		// Read the rest of the entry from the same mapped file, instead
+		// of reading it again for the menu item and for the launcher. The
+		// menu item is a new object that no other thread sees until the
+		// workers are joined, and creating it does not go through the
+		// shared item cache of pojk.
+		GKeyFile* key_file = g_key_file_new();
+		if (g_key_file_load_from_data(key_file, g_mapped_file_get_contents(file), g_mapped_file_get_length(file), G_KEY_FILE_NONE, NULL))
+		{
+			read_entry(entry, key_file);
+		}
+		g_key_file_free(key_file);
+	}
+
+	g_mapped_file_unref(file);
+
+	worker->results.push_back(result);
+}
+
+//-----------------------------------------------------------------------------
+
+void DesktopEntryLoader::read_entry(Entry& entry, GKeyFile* key_file) const
+{
+	// Only the parts of the menu item that launchers use are set
+	GFile* file = g_file_new_for_path(entry.path.c_str());
+	entry.menu_item = POJK_MENU_ITEM(g_object_new(POJK_TYPE_MENU_ITEM, "file", file, NULL));
+	g_object_unref(file);
+	pojk_menu_item_set_desktop_id(entry.menu_item, entry.desktop_id.c_str());
+
+	gchar* value = g_key_file_get_locale_string(key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_NAME, NULL, NULL);
+	pojk_menu_item_set_name(entry.menu_item, value);
+	g_free(value);
+
+	value = g_key_file_get_locale_string(key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_GENERIC_NAME, NULL, NULL);
+	pojk_menu_item_set_generic_name(entry.menu_item, value);
+	g_free(value);
+
+	value = g_key_file_get_locale_string(key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_COMMENT, NULL, NULL);
+	pojk_menu_item_set_comment(entry.menu_item, value);
+	g_free(value);
+
+	value = g_key_file_get_locale_string(key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_ICON, NULL, NULL);
+	pojk_menu_item_set_icon_name(entry.menu_item, value);
+	g_free(value);
+
+	value = g_key_file_get_string(key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_EXEC, NULL);
+	pojk_menu_item_set_command(entry.menu_item, value);
+	g_free(value);
+
+	value = g_key_file_get_string(key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_PATH, NULL);
+	pojk_menu_item_set_path(entry.menu_item, value);
+	g_free(value);
+
+	pojk_menu_item_set_requires_terminal(entry.menu_item,
+			g_key_file_get_boolean(key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_TERMINAL, NULL));
+	pojk_menu_item_set_supports_startup_notification(entry.menu_item,
+			g_key_file_get_boolean(key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_STARTUP_NOTIFY, NULL));
+
+#ifdef POJK_TYPE_MENU_ITEM_ACTION
+	gchar** actions = g_key_file_get_string_list(key_file, G_KEY_FILE_DESKTOP_GROUP, "Actions", NULL, NULL);
+	if (actions)
+	{
+		for (gchar** name = actions; *name; ++name)
+		{
+			gchar* group = g_strdup_printf("Desktop Action %s", *name);
+			if (g_key_file_has_group(key_file, group))
+			{
+				PojkMenuItemAction* action = pojk_menu_item_action_new();
+
+				value = g_key_file_get_locale_string(key_file, group, G_KEY_FILE_DESKTOP_KEY_NAME, NULL, NULL);
+				pojk_menu_item_action_set_name(action, value);
+				g_free(value);
+
+				value = g_key_file_get_string(key_file, group, G_KEY_FILE_DESKTOP_KEY_EXEC, NULL);
+				pojk_menu_item_action_set_command(action, value);
+				g_free(value);
+
+				value = g_key_file_get_locale_string(key_file, group, G_KEY_FILE_DESKTOP_KEY_ICON, NULL, NULL);
+				pojk_menu_item_action_set_icon_name(action, value);
+				g_free(value);
+
+				pojk_menu_item_set_action(entry.menu_item, *name, action);
+				g_object_unref(action);
+			}
+			g_free(group);
+		}
+		g_strfreev(actions);
+	}
+#endif
+
+	// Create the text of the launcher here as well, including search text
+	// that the menu item does not provide; only adding search tokens to the
+	// shared dictionary is left for when the results are merged
+	gchar** keywords = g_key_file_get_locale_string_list(key_file, G_KEY_FILE_DESKTOP_GROUP, "Keywords", NULL, NULL, NULL);
+	gchar** mime_types = g_key_file_get_string_list(key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_MIME_TYPE, NULL, NULL);
+	entry.text = new Launcher::Text;
+	Launcher::create_text(entry.menu_item, keywords, mime_types, m_options, *entry.text);
+	g_strfreev(keywords);
+	g_strfreev(mime_types);
+}
+
+//-----------------------------------------------------------------------------
+
+void DesktopEntryLoader::free_entry(Entry& entry)
+{
+	if (entry.menu_item)
+	{
+		g_object_unref(entry.menu_item);
+		entry.menu_item = NULL;
+	}
+	delete entry.text;
+	entry.text = NULL;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_DESKTOP_ENTRY_LOADER_H
+#define BLADEMENU_DESKTOP_ENTRY_LOADER_H
+
+#include "launcher.h"
+
+#include <string>
+#include <vector>
+
+#include <pojk/pojk.h>
+
+namespace BladeMenu
+{
+
+class DesktopEntryLoader
+{
+public:
+	explicit DesktopEntryLoader(const Launcher::Options& options);
+	~DesktopEntryLoader();
+
+	struct Entry
+	{
+		std::string desktop_id;
+		std::string path;
+		PojkMenuItem* menu_item;
+		Launcher::Text* text;
+		guint directories;
+	};
+
+	static bool enabled();
+	static void read_search_text(const gchar* path, gchar**& keywords, gchar**& mime_types);
+
+	void load();
+
+	const std::vector<std::string>& get_directories() const
+	{
+		return m_directories;
+	}
+
+	const std::vector<Entry>& get_entries() const
+	{
+		return m_entries;
+	}
+
+	const std::vector<std::string>& get_folders() const
+	{
+		return m_folders;
+	}
+
+private:
+	DesktopEntryLoader(const DesktopEntryLoader&);
+	DesktopEntryLoader& operator=(const DesktopEntryLoader&);
+
+	struct Task
+	{
+		std::string path;
+		std::string desktop_id;
+		guint base;
+		bool folder;
+	};
+
+	struct Result
+	{
+		guint base;
+		Entry entry;
+
+		static bool less_than(const Result& lhs, const Result& rhs);
+	};
+
+	class Worker;
+
+	void run(Worker* worker);
+	void wake_workers();
+	static gpointer run_thread(gpointer data);
+	void load_folder(Worker* worker, const Task& task);
+	void load_entry(Worker* worker, const Task& task);
+	void read_entry(Entry& entry, GKeyFile* key_file) const;
+	static void free_entry(Entry& entry);
+
+private:
+	const Launcher::Options m_options;
+	const gchar* m_environment;
+	std::vector<std::string> m_directories;
+	std::vector<Entry> m_entries;
+	std::vector<std::string> m_folders;
+	std::vector<Worker*> m_workers;
+	volatile gint m_pending;
+	volatile gint m_queued;
+	GMutex m_idle_mutex;
+	GCond m_idle_cond;
+};
+
+}
+
+#endif // BLADEMENU_DESKTOP_ENTRY_LOADER_H
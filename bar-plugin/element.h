@@ -18,6 +18,8 @@
 #ifndef BLADEMENU_ELEMENT_H
 #define BLADEMENU_ELEMENT_H
 
+#include "memory-report.h"
+
 #include <gdk/gdk.h>
 
 namespace BladeMenu
@@ -32,7 +34,8 @@ public:
 		m_icon(NULL),
 		m_text(NULL),
 		m_tooltip(NULL),
-		m_sort_key(NULL)
+		m_sort_key(NULL),
+		m_sort_rank(G_MAXUINT)
 	{
 	}
 
@@ -61,6 +64,14 @@ public:
 		return m_tooltip;
 	}
 
+	void measure(MemoryReport& report, MemoryReport::Subsystem subsystem) const
+	{
+		report.add_string(MemoryReport::Icons, m_icon);
+		report.add_string(subsystem, m_text);
+		report.add_string(subsystem, m_tooltip);
+		report.add_string(subsystem, m_sort_key);
+	}
+
 	virtual void run(GdkScreen*) const
 	{
 	}
@@ -70,11 +81,21 @@ public:
 		return G_MAXUINT;
 	}
 
+	void set_sort_rank(guint rank)
+	{
+		m_sort_rank = rank;
+	}
+
 	static bool less_than(const Element* lhs, const Element* rhs)
 	{
 		return g_strcmp0(lhs->m_sort_key, rhs->m_sort_key) < 0;
 	}
 
+	static bool less_than_rank(const Element* lhs, const Element* rhs)
+	{
+		return lhs->m_sort_rank < rhs->m_sort_rank;
+	}
+
 protected:
 	void set_icon(const gchar* icon)
 	{
@@ -104,6 +125,14 @@ protected:
 		m_sort_key = g_utf8_collate_key(m_text, -1);
 	}
 
+	void set_text(const gchar* text, const gchar* sort_key)
+	{
+		g_free(m_text);
+		g_free(m_sort_key);
+		m_text = g_strdup(text);
+		m_sort_key = g_strdup(sort_key);
+	}
+
 	void set_tooltip(const gchar* tooltip)
 	{
 		g_free(m_tooltip);
@@ -119,6 +148,7 @@ private:
 	gchar* m_text;
 	gchar* m_tooltip;
 	gchar* m_sort_key;
+	guint m_sort_rank;
 };
 
 }
@@ -43,6 +43,8 @@ static gboolean is_separator(GtkTreeModel* model, GtkTreeIter* iter, gpointer)
 LauncherView::LauncherView(Window* window) :
 	m_window(window),
 	m_model(NULL),
+	m_text_func(NULL),
+	m_text_func_data(NULL),
 	m_icon_size(0),
 	m_pressed_launcher(NULL),
 	m_drag_enabled(true),
@@ -247,6 +249,17 @@ void LauncherView::reload_icon_size()
 
 //-----------------------------------------------------------------------------
 
+void LauncherView::set_text_func(GtkTreeCellDataFunc func, gpointer data)
+{
+	// Only called for rows that are drawn or measured
+	m_text_func = func;
+	m_text_func_data = data;
+	gtk_tree_view_remove_column(m_view, m_column);
+	create_column();
+}
+
+//-----------------------------------------------------------------------------
+
 void LauncherView::create_column()
 {
 	m_icon_size = wm_settings->launcher_icon_size.get_size();
@@ -267,7 +280,14 @@ void LauncherView::create_column()
 	GtkCellRenderer* text_renderer = gtk_cell_renderer_text_new();
 	g_object_set(text_renderer, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
 	gtk_tree_view_column_pack_start(m_column, text_renderer, true);
-	gtk_tree_view_column_add_attribute(m_column, text_renderer, "markup", LauncherView::COLUMN_TEXT);
+	if (m_text_func)
+	{
+		gtk_tree_view_column_set_cell_data_func(m_column, text_renderer, m_text_func, m_text_func_data, NULL);
+	}
+	else
+	{
+		gtk_tree_view_column_add_attribute(m_column, text_renderer, "markup", LauncherView::COLUMN_TEXT);
+	}
 
 	gtk_tree_view_column_set_sizing(m_column, GTK_TREE_VIEW_COLUMN_FIXED);
 
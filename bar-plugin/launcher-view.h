@@ -63,6 +63,8 @@ public:
 
 	void reload_icon_size();
 
+	void set_text_func(GtkTreeCellDataFunc func, gpointer data);
+
 	enum Columns
 	{
 		COLUMN_ICON = 0,
@@ -89,6 +91,8 @@ private:
 	GtkTreeModel* m_model;
 	GtkTreeView* m_view;
 	GtkTreeViewColumn* m_column;
+	GtkTreeCellDataFunc m_text_func;
+	gpointer m_text_func_data;
 	int m_icon_size;
 
 	Launcher* m_pressed_launcher;
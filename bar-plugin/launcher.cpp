@@ -17,8 +17,14 @@
 
 #include "launcher.h"
 
+#include "command-template.h"
 #include "query.h"
 #include "settings.h"
+#include "spawner.h"
+#include "token-dictionary.h"
+#include "transliteration.h"
+
+#include <algorithm>
 
 #include <blxo/blxo.h>
 #include <libbladeui/libbladeui.h>
@@ -54,55 +60,92 @@ static std::string normalize(const gchar* string)
 
 //-----------------------------------------------------------------------------
 
-static void replace_with_quoted_string(std::string& command, size_t& index, const gchar* unquoted)
+static gchar* quote_string(const gchar* prefix, const gchar* unquoted)
 {
-	if (!blxo_str_is_empty(unquoted))
+	if (blxo_str_is_empty(unquoted))
 	{
-		gchar* quoted = g_shell_quote(unquoted);
-		command.replace(index, 2, quoted);
-		index += strlen(quoted);
-		g_free(quoted);
+		return NULL;
 	}
-	else
+
+	gchar* quoted = g_shell_quote(unquoted);
+	gchar* result = g_strconcat(prefix, quoted, NULL);
+	g_free(quoted);
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+
+static void insert_tokens(TokenDictionary* dictionary, const std::string& token, std::vector<guint32>& tokens)
+{
+	if (token.empty())
 	{
-		command.erase(index, 2);
+		return;
+	}
+
+	guint32 id = dictionary->insert(token);
+	if (std::find(tokens.begin(), tokens.end(), id) == tokens.end())
+	{
+		tokens.push_back(id);
 	}
 }
 
 //-----------------------------------------------------------------------------
 
-static void replace_with_quoted_string(std::string& command, size_t& index, const char* prefix, const gchar* unquoted)
+static void split_mime_type(const gchar* mime_type, std::vector<std::string>& words)
 {
-	if (!blxo_str_is_empty(unquoted))
+	// Only search subtype, because top-level types are too broad
+	const gchar* subtype = strchr(mime_type, '/');
+	if (!subtype || !g_utf8_validate(subtype, -1, NULL))
 	{
-		command.replace(index, 2, prefix);
-		index += strlen(prefix);
+		return;
+	}
+	++subtype;
 
-		gchar* quoted = g_shell_quote(unquoted);
-		command.insert(index, quoted);
-		index += strlen(quoted);
-		g_free(quoted);
+	// Strip vendor and experimental prefixes
+	if (g_str_has_prefix(subtype, "x-"))
+	{
+		subtype += 2;
 	}
-	else
+	else if (g_str_has_prefix(subtype, "vnd."))
 	{
-		command.erase(index, 2);
+		subtype += 4;
 	}
+
+	// Split subtype into words
+	gchar** split = g_strsplit_set(subtype, ".-+", -1);
+	for (gchar** word = split; *word; ++word)
+	{
+		if ((strcmp(*word, "x") != 0) && (strcmp(*word, "vnd") != 0))
+		{
+			words.push_back(normalize(*word));
+		}
+	}
+	g_strfreev(split);
 }
 
 //-----------------------------------------------------------------------------
 
-static void replace_and_free_with_quoted_string(std::string& command, size_t& index, gchar* unquoted)
+Launcher::Options::Options() :
+	show_name(wm_settings->launcher_show_name),
+	show_description(wm_settings->launcher_show_description),
+	transliterate(wm_settings->search_transliterate),
+	right_to_left(gtk_widget_get_default_direction() == GTK_TEXT_DIR_RTL)
 {
-	replace_with_quoted_string(command, index, unquoted);
-	g_free(unquoted);
 }
 
 //-----------------------------------------------------------------------------
 
-Launcher::Launcher(PojkMenuItem* item) :
+Launcher::Launcher(PojkMenuItem* item, TokenDictionary* dictionary, const Text& text) :
 	m_item(item),
-	m_search_flags(0)
+	m_dictionary(dictionary),
+	m_name_spans_serial(0),
+	m_speculative_spans_serial(0),
+	m_search_flags(0),
+	m_argv(NULL)
 {
+	// Keep item, which is not owned by a menu if read from a desktop entry
+	g_object_ref(m_item);
+
 	// Fetch icon
 	const gchar* icon = pojk_menu_item_get_icon_name(m_item);
 	if (G_LIKELY(icon))
@@ -137,53 +180,18 @@ Launcher::Launcher(PojkMenuItem* item) :
 		}
 	}
 
-	// Fetch text
-	const gchar* name = pojk_menu_item_get_name(m_item);
-	if (G_UNLIKELY(!name) || !g_utf8_validate(name, -1, NULL))
-	{
-		name = "";
-	}
-
-	const gchar* generic_name = pojk_menu_item_get_generic_name(m_item);
-	if (G_UNLIKELY(!generic_name) || !g_utf8_validate(generic_name, -1, NULL))
-	{
-		generic_name = "";
-	}
-
-	if (!wm_settings->launcher_show_name && !blxo_str_is_empty(generic_name))
-	{
-		std::swap(name, generic_name);
-	}
-	m_display_name = name;
-
-	const gchar* details = pojk_menu_item_get_comment(m_item);
-	if (!details || !g_utf8_validate(details, -1, NULL))
-	{
-		details = generic_name;
-	}
+	// Set text
+	apply_text(text);
 
-	// Create display text
-	const gchar* direction = (gtk_widget_get_default_direction() != GTK_TEXT_DIR_RTL) ? "\342\200\216" : "\342\200\217";
-	if (wm_settings->launcher_show_description)
-	{
-		set_text(g_markup_printf_escaped("%s<b>%s</b>\n%s%s", direction, m_display_name, direction, details));
-	}
-	else
+	// Add search tokens for keywords and MIME types to the dictionary, which
+	// is shared by all launchers
+	for (std::vector<std::string>::const_iterator i = text.keywords.begin(), end = text.keywords.end(); i != end; ++i)
 	{
-		set_text(g_markup_printf_escaped("%s%s", direction, m_display_name));
+		insert_tokens(dictionary, *i, m_search_keywords);
 	}
-	set_tooltip(details);
-
-	// Create search text for display name
-	m_search_name = normalize(m_display_name);
-	m_search_generic_name = normalize(generic_name);
-	m_search_comment = normalize(details);
-
-	// Create search text for command
-	const gchar* command = pojk_menu_item_get_command(m_item);
-	if (!blxo_str_is_empty(command) && g_utf8_validate(command, -1, NULL))
+	for (std::vector<std::string>::const_iterator i = text.mime_types.begin(), end = text.mime_types.end(); i != end; ++i)
 	{
-		m_search_command = normalize(command);
+		insert_tokens(dictionary, *i, m_search_mime_types);
 	}
 
 	// Fetch desktop actions
@@ -205,6 +213,9 @@ Launcher::Launcher(PojkMenuItem* item) :
 
 Launcher::~Launcher()
 {
+	g_strfreev(m_argv);
+	g_object_unref(m_item);
+
 	for (std::vector<DesktopAction*>::size_type i = 0, end = m_actions.size(); i < end; ++i)
 	{
 		delete m_actions[i];
@@ -213,76 +224,159 @@ Launcher::~Launcher()
 
 //-----------------------------------------------------------------------------
 
-void Launcher::run(GdkScreen* screen) const
+void Launcher::apply_text(const Text& text)
+{
+	m_display_name = text.display_name;
+	set_text(text.text.c_str(), text.sort_key.c_str());
+	set_tooltip(text.details);
+
+	m_search_name = text.search_name;
+	m_search_generic_name = text.search_generic_name;
+	m_search_name_romanized = text.search_name_romanized;
+	m_search_generic_name_romanized = text.search_generic_name_romanized;
+	m_search_comment = text.search_comment;
+	m_search_command = text.search_command;
+	m_search_name_folded = text.search_name_folded;
+	m_search_generic_name_folded = text.search_generic_name_folded;
+}
+
+//-----------------------------------------------------------------------------
+
+bool Launcher::parse_command(GError** error) const
 {
 	const gchar* string = pojk_menu_item_get_command(m_item);
 	if (blxo_str_is_empty(string))
 	{
-		return;
+		return false;
+	}
+
+	// Expand the field codes
+	gchar* uri = pojk_menu_item_get_uri(m_item);
+	gchar* values[CommandTemplate::CountFields] = { NULL };
+	values[CommandTemplate::FieldIcon] = quote_string("--icon ", pojk_menu_item_get_icon_name(m_item));
+	values[CommandTemplate::FieldName] = quote_string("", pojk_menu_item_get_name(m_item));
+	values[CommandTemplate::FieldLocation] = quote_string("", uri);
+	g_free(uri);
+
+	std::string command;
+	CommandTemplate(string).expand(values, command);
+	for (int i = 0; i < CommandTemplate::CountFields; ++i)
+	{
+		g_free(values[i]);
 	}
-	std::string command(string);
 
 	if (pojk_menu_item_requires_terminal(m_item))
 	{
 		command.insert(0, "blxo-open --launch TerminalEmulator ");
 	}
 
-	// Expand the field codes
-	size_t length = command.length() - 1;
-	for (size_t i = 0; i < length; ++i)
+	if (!g_shell_parse_argv(command.c_str(), NULL, &m_argv, error))
 	{
-		if (G_UNLIKELY(command[i] == '%'))
-		{
-			switch (command[i + 1])
-			{
-			case 'i':
-				replace_with_quoted_string(command, i, "--icon ", pojk_menu_item_get_icon_name(m_item));
-				break;
+		m_argv = NULL;
+		return false;
+	}
 
-			case 'c':
-				replace_with_quoted_string(command, i, pojk_menu_item_get_name(m_item));
-				break;
+	return true;
+}
 
-			case 'k':
-				replace_and_free_with_quoted_string(command, i, pojk_menu_item_get_uri(m_item));
-				break;
+//-----------------------------------------------------------------------------
 
-			case '%':
-				command.erase(i, 1);
-				break;
+void Launcher::measure(MemoryReport& report) const
+{
+	report.add(MemoryReport::Launchers, sizeof(Launcher));
+	Element::measure(report, MemoryReport::Launchers);
 
-			case 'f':
-				// unsupported, pass in a single file dropped on launcher
-			case 'F':
-				// unsupported, pass in a list of files dropped on launcher
-			case 'u':
-				// unsupported, pass in a single URL dropped on launcher
-			case 'U':
-				// unsupported, pass in a list of URLs dropped on launcher
-			default:
-				command.erase(i, 2);
-				break;
-			}
-			length = command.length() - 1;
+	report.add_vector(MemoryReport::Launchers, m_actions);
+	report.add(MemoryReport::Launchers, m_actions.size() * sizeof(DesktopAction));
+
+	if (m_argv)
+	{
+		for (gchar** arg = m_argv; *arg; ++arg)
+		{
+			report.add(MemoryReport::Launchers, sizeof(gchar*));
+			report.add_string(MemoryReport::Launchers, *arg);
 		}
 	}
 
-	// Parse and spawn command
-	gchar** argv;
-	gboolean result = false;
+	report.add(MemoryReport::SearchIndex, m_search_name.get_size());
+	report.add(MemoryReport::SearchIndex, m_search_generic_name.get_size());
+	report.add(MemoryReport::SearchIndex, m_search_name_romanized.get_size());
+	report.add(MemoryReport::SearchIndex, m_search_generic_name_romanized.get_size());
+	report.add(MemoryReport::SearchIndex, m_search_comment.get_size());
+	report.add(MemoryReport::SearchIndex, m_search_command.get_size());
+	report.add(MemoryReport::FoldedText, m_search_name_folded.get_size());
+	report.add(MemoryReport::FoldedText, m_search_generic_name_folded.get_size());
+	report.add_vector(MemoryReport::SearchIndex, m_search_keywords);
+	report.add_vector(MemoryReport::SearchIndex, m_search_mime_types);
+	report.add_vector(MemoryReport::SearchIndex, m_name_spans);
+	report.add_vector(MemoryReport::SearchIndex, m_speculative_spans);
+
+	report.add_object(MemoryReport::Menu, m_item);
+	report.add_string(MemoryReport::Menu, pojk_menu_item_get_desktop_id(m_item));
+	report.add_string(MemoryReport::Menu, pojk_menu_item_get_name(m_item));
+	report.add_string(MemoryReport::Menu, pojk_menu_item_get_generic_name(m_item));
+	report.add_string(MemoryReport::Menu, pojk_menu_item_get_comment(m_item));
+	report.add_string(MemoryReport::Menu, pojk_menu_item_get_command(m_item));
+	report.add_string(MemoryReport::Menu, pojk_menu_item_get_icon_name(m_item));
+	report.add_string(MemoryReport::Menu, pojk_menu_item_get_path(m_item));
+}
+
+//-----------------------------------------------------------------------------
+
+void Launcher::prefetch() const
+{
+	if (!m_argv && !parse_command(NULL))
+	{
+		return;
+	}
+
+	// Skip the terminal launcher, which is usually already cached
+	guint index = pojk_menu_item_requires_terminal(m_item) ? 3 : 0;
+	if (g_strv_length(m_argv) <= index)
+	{
+		return;
+	}
+
+	gchar* program = Spawner::find_program(m_argv[index]);
+	Spawner::prefetch(program);
+	g_free(program);
+
+	// Menu items are not guaranteed to have a file
+	GFile* file = get_file();
+	if (file)
+	{
+		gchar* path = g_file_get_path(file);
+		g_object_unref(file);
+		Spawner::prefetch(path);
+		g_free(path);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void Launcher::run(GdkScreen* screen) const
+{
+	const gchar* string = pojk_menu_item_get_command(m_item);
+	if (blxo_str_is_empty(string))
+	{
+		return;
+	}
+
+	// Parse the command the first time it is run
 	GError* error = NULL;
-	if (g_shell_parse_argv(command.c_str(), NULL, &argv, &error))
+	if (!m_argv)
 	{
-		result = xfce_spawn_on_screen(screen,
-				pojk_menu_item_get_path(m_item),
-				argv, NULL, G_SPAWN_SEARCH_PATH,
-				pojk_menu_item_supports_startup_notification(m_item),
-				gtk_get_current_event_time(),
-				pojk_menu_item_get_icon_name(m_item),
-				&error);
-		g_strfreev(argv);
+		parse_command(&error);
 	}
 
+	// Spawn command
+	bool result = m_argv && Spawner::run(screen,
+			pojk_menu_item_get_path(m_item),
+			m_argv,
+			pojk_menu_item_supports_startup_notification(m_item),
+			pojk_menu_item_get_icon_name(m_item),
+			&error);
+
 	if (G_UNLIKELY(!result))
 	{
 		xfce_dialog_show_error(NULL, error, _("Failed to execute command \"%s\"."), string);
@@ -299,59 +393,32 @@ void Launcher::run(GdkScreen* screen, DesktopAction* action) const
 	{
 		return;
 	}
-	std::string command(string);
 
 	// Expand the field codes
-	size_t length = command.length() - 1;
-	for (size_t i = 0; i < length; ++i)
+	gchar* uri = pojk_menu_item_get_uri(m_item);
+	gchar* values[CommandTemplate::CountFields] = { NULL };
+	values[CommandTemplate::FieldIcon] = quote_string("--icon ", action->get_icon());
+	values[CommandTemplate::FieldName] = quote_string("", action->get_name());
+	values[CommandTemplate::FieldLocation] = quote_string("", uri);
+	g_free(uri);
+
+	std::string command;
+	CommandTemplate(string).expand(values, command);
+	for (int i = 0; i < CommandTemplate::CountFields; ++i)
 	{
-		if (G_UNLIKELY(command[i] == '%'))
-		{
-			switch (command[i + 1])
-			{
-			case 'i':
-				replace_with_quoted_string(command, i, "--icon ", action->get_icon());
-				break;
-
-			case 'c':
-				replace_with_quoted_string(command, i, action->get_name());
-				break;
-
-			case 'k':
-				replace_and_free_with_quoted_string(command, i, pojk_menu_item_get_uri(m_item));
-				break;
-
-			case '%':
-				command.erase(i, 1);
-				break;
-
-			case 'f':
-				// unsupported, pass in a single file dropped on launcher
-			case 'F':
-				// unsupported, pass in a list of files dropped on launcher
-			case 'u':
-				// unsupported, pass in a single URL dropped on launcher
-			case 'U':
-				// unsupported, pass in a list of URLs dropped on launcher
-			default:
-				command.erase(i, 2);
-				break;
-			}
-			length = command.length() - 1;
-		}
+		g_free(values[i]);
 	}
 
 	// Parse and spawn command
 	gchar** argv;
-	gboolean result = false;
+	bool result = false;
 	GError* error = NULL;
 	if (g_shell_parse_argv(command.c_str(), NULL, &argv, &error))
 	{
-		result = xfce_spawn_on_screen(screen,
+		result = Spawner::run(screen,
 				pojk_menu_item_get_path(m_item),
-				argv, NULL, G_SPAWN_SEARCH_PATH,
+				argv,
 				pojk_menu_item_supports_startup_notification(m_item),
-				gtk_get_current_event_time(),
 				action->get_icon(),
 				&error);
 		g_strfreev(argv);
@@ -371,31 +438,93 @@ guint Launcher::search(const Query& query)
 	// Prioritize matches in favorites and recent, then favories, and then recent
 	const guint flags = 3 - m_search_flags;
 
-	// Sort matches in names first
-	guint match = query.match(m_search_name);
+	// Sort matches in names first, and remember where the display name
+	// matched to highlight it; speculative queries keep their own spans, so
+	// that the spans of the results on screen are not replaced
+	std::vector<SearchText::Span>* spans = &m_name_spans;
+	unsigned int* spans_serial = &m_name_spans_serial;
+	if (query.get_speculative())
+	{
+		spans = &m_speculative_spans;
+		spans_serial = &m_speculative_spans_serial;
+	}
+	*spans_serial = query.get_serial();
+	guint match = query.match(m_search_name, spans);
 	if (match != G_MAXUINT)
 	{
 		return match | flags | 0x400;
 	}
 
+	if (!m_search_name_romanized.empty())
+	{
+		match = query.match(m_search_name_romanized);
+		if (match != G_MAXUINT)
+		{
+			return match | flags | 0x400;
+		}
+	}
+
 	match = query.match(m_search_generic_name);
 	if (match != G_MAXUINT)
 	{
 		return match | flags | 0x800;
 	}
 
+	if (!m_search_generic_name_romanized.empty())
+	{
+		match = query.match(m_search_generic_name_romanized);
+		if (match != G_MAXUINT)
+		{
+			return match | flags | 0x800;
+		}
+	}
+
+	// Sort matches in keywords next
+	match = m_dictionary->match(query, m_search_keywords);
+	if (match != G_MAXUINT)
+	{
+		return match | flags | 0x1000;
+	}
+
 	// Sort matches in comments next
 	match = query.match(m_search_comment);
 	if (match != G_MAXUINT)
 	{
-		return match | flags | 0x1000;
+		return match | flags | 0x2000;
 	}
 
-	// Sort matches in executables last
+	// Sort matches in executables next
 	match = query.match(m_search_command);
 	if (match != G_MAXUINT)
 	{
-		return match | flags | 0x2000;
+		return match | flags | 0x4000;
+	}
+
+	// Sort accent-insensitive matches in names next; only searched if either
+	// the launcher or the query has diacritics
+	if (!m_search_name_folded.empty() || query.has_diacritics())
+	{
+		match = query.match_folded(!m_search_name_folded.empty() ? m_search_name_folded : m_search_name);
+		if (match != G_MAXUINT)
+		{
+			return match | flags | 0x8000;
+		}
+	}
+
+	if (!m_search_generic_name_folded.empty() || query.has_diacritics())
+	{
+		match = query.match_folded(!m_search_generic_name_folded.empty() ? m_search_generic_name_folded : m_search_generic_name);
+		if (match != G_MAXUINT)
+		{
+			return match | flags | 0x8000;
+		}
+	}
+
+	// Sort matches in MIME types last
+	match = m_dictionary->match(query, m_search_mime_types);
+	if (match != G_MAXUINT)
+	{
+		return match | flags | 0x10000;
 	}
 
 	return G_MAXUINT;
@@ -403,6 +532,214 @@ guint Launcher::search(const Query& query)
 
 //-----------------------------------------------------------------------------
 
+gchar* Launcher::create_highlighted_text(const Query& query) const
+{
+	// Results restored from an earlier query were last matched against a
+	// different one, so match the name again
+	if (m_name_spans_serial != query.get_serial())
+	{
+		m_name_spans_serial = query.get_serial();
+		query.match(m_search_name, &m_name_spans);
+	}
+
+	if (m_name_spans.empty())
+	{
+		return NULL;
+	}
+
+	// Map spans in the normalized name back to characters of display name
+	GString* name = g_string_sized_new(strlen(m_display_name) * 2);
+	std::string::size_type offset = 0;
+	bool highlighted = false;
+	for (const gchar* pos = m_display_name; *pos; pos = g_utf8_next_char(pos))
+	{
+		const gchar* next = g_utf8_next_char(pos);
+
+		std::string::size_type length = 1;
+		if (static_cast<guchar>(*pos) >= 0x80)
+		{
+			gchar* character = g_strndup(pos, next - pos);
+			length = normalize(character).length();
+			g_free(character);
+		}
+
+		bool matched = false;
+		for (std::vector<SearchText::Span>::const_iterator i = m_name_spans.begin(), end = m_name_spans.end(); i != end; ++i)
+		{
+			if ((i->start < offset + length) && (i->end > offset))
+			{
+				matched = true;
+				break;
+			}
+		}
+		offset += length;
+
+		if (matched != highlighted)
+		{
+			g_string_append(name, matched ? "<u>" : "</u>");
+			highlighted = matched;
+		}
+
+		gchar* escaped = g_markup_escape_text(pos, next - pos);
+		g_string_append(name, escaped);
+		g_free(escaped);
+	}
+	if (highlighted)
+	{
+		g_string_append(name, "</u>");
+	}
+
+	// Create display text in the same layout as the unhighlighted text
+	gchar* text = NULL;
+	const gchar* direction = (gtk_widget_get_default_direction() != GTK_TEXT_DIR_RTL) ? "\342\200\216" : "\342\200\217";
+	if (wm_settings->launcher_show_description)
+	{
+		text = g_strdup_printf("%s<b>%s</b>\n%s%s", direction, name->str, direction, get_tooltip());
+	}
+	else
+	{
+		text = g_strdup_printf("%s%s", direction, name->str);
+	}
+	g_string_free(name, true);
+
+	return text;
+}
+
+//-----------------------------------------------------------------------------
+
+gunichar Launcher::get_next_character(const Query& query) const
+{
+	// Only known if the name was the last text matched against the query
+	const std::vector<SearchText::Span>& spans = query.get_speculative() ? m_speculative_spans : m_name_spans;
+	const unsigned int spans_serial = query.get_speculative() ? m_speculative_spans_serial : m_name_spans_serial;
+	if ((spans_serial != query.get_serial()) || spans.empty())
+	{
+		return 0;
+	}
+
+	std::string::size_type end = 0;
+	for (std::vector<SearchText::Span>::const_iterator i = spans.begin(), spans_end = spans.end(); i != spans_end; ++i)
+	{
+		end = std::max(end, i->end);
+	}
+
+	const std::string& name = m_search_name.str();
+	if (end >= name.length())
+	{
+		return 0;
+	}
+	return g_utf8_get_char(name.c_str() + end);
+}
+
+//-----------------------------------------------------------------------------
+
+void Launcher::create_text(PojkMenuItem* item, const gchar* const* keywords, const gchar* const* mime_types, const Options& options, Text& text)
+{
+	const gchar* name = pojk_menu_item_get_name(item);
+	if (G_UNLIKELY(!name) || !g_utf8_validate(name, -1, NULL))
+	{
+		name = "";
+	}
+
+	const gchar* generic_name = pojk_menu_item_get_generic_name(item);
+	if (G_UNLIKELY(!generic_name) || !g_utf8_validate(generic_name, -1, NULL))
+	{
+		generic_name = "";
+	}
+
+	if (!options.show_name && !blxo_str_is_empty(generic_name))
+	{
+		std::swap(name, generic_name);
+	}
+	text.display_name = name;
+
+	const gchar* details = pojk_menu_item_get_comment(item);
+	if (!details || !g_utf8_validate(details, -1, NULL))
+	{
+		details = generic_name;
+	}
+	text.details = details;
+
+	// Create display text
+	const gchar* direction = !options.right_to_left ? "\342\200\216" : "\342\200\217";
+	gchar* display = NULL;
+	if (options.show_description)
+	{
+		display = g_markup_printf_escaped("%s<b>%s</b>\n%s%s", direction, name, direction, details);
+	}
+	else
+	{
+		display = g_markup_printf_escaped("%s%s", direction, name);
+	}
+	gchar* sort_key = g_utf8_collate_key(display, -1);
+	text.text = display;
+	text.sort_key = sort_key;
+	g_free(display);
+	g_free(sort_key);
+
+	// Create search text for display name
+	text.search_name = normalize(name);
+	text.search_generic_name = normalize(generic_name);
+	text.search_comment = normalize(details);
+
+	// Create romanized search text for names written in Han or Kana
+	if (options.transliterate)
+	{
+		text.search_name_romanized = Transliteration::romanize(text.search_name.str());
+		text.search_generic_name_romanized = Transliteration::romanize(text.search_generic_name.str());
+	}
+
+	// Create accent-insensitive search text for names
+	const gint64 fold_start = g_get_monotonic_time();
+	text.search_name_folded = Query::fold(text.search_name.str());
+	text.search_generic_name_folded = Query::fold(text.search_generic_name.str());
+	text.fold_time = g_get_monotonic_time() - fold_start;
+
+	// Create search text for command
+	const gchar* command = pojk_menu_item_get_command(item);
+	if (!blxo_str_is_empty(command) && g_utf8_validate(command, -1, NULL))
+	{
+		text.search_command = normalize(command);
+	}
+
+	// Create search words for keywords and MIME types, which are not
+	// provided by pojk and are read along with the menu
+	if (keywords)
+	{
+		for (const gchar* const* keyword = keywords; *keyword; ++keyword)
+		{
+			if (g_utf8_validate(*keyword, -1, NULL))
+			{
+				text.keywords.push_back(normalize(*keyword));
+			}
+		}
+	}
+	if (mime_types)
+	{
+		for (const gchar* const* mime_type = mime_types; *mime_type; ++mime_type)
+		{
+			split_mime_type(*mime_type, text.mime_types);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void Launcher::update_text(const Options& options)
+{
+	Text text;
+	create_text(m_item, NULL, NULL, options, text);
+	apply_text(text);
+
+	// Highlight spans were found in the previous display name
+	m_name_spans.clear();
+	m_name_spans_serial = 0;
+	m_speculative_spans.clear();
+	m_speculative_spans_serial = 0;
+}
+
+//-----------------------------------------------------------------------------
+
 void Launcher::set_flag(SearchFlag flag, bool enabled)
 {
 	if (enabled)
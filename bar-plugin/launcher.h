@@ -19,6 +19,7 @@
 #define BLADEMENU_LAUNCHER_H
 
 #include "element.h"
+#include "search-text.h"
 
 #include <string>
 #include <vector>
@@ -28,6 +29,8 @@
 namespace BladeMenu
 {
 
+class TokenDictionary;
+
 class DesktopAction
 {
 #ifdef POJK_TYPE_MENU_ITEM_ACTION
@@ -80,7 +83,42 @@ public:
 class Launcher : public Element
 {
 public:
-	explicit Launcher(PojkMenuItem* item);
+	// Settings that the text of launchers depends on, read in the main
+	// thread so that launchers can be created while the settings change
+	struct Options
+	{
+		Options();
+
+		bool show_name;
+		bool show_description;
+		bool transliterate;
+		bool right_to_left;
+	};
+
+	// Display and search text, which only depends on the menu item and so
+	// can be created on the threads that read desktop entries
+	struct Text
+	{
+		const gchar* display_name;
+		const gchar* details;
+		std::string text;
+		std::string sort_key;
+		SearchText search_name;
+		SearchText search_generic_name;
+		SearchText search_name_romanized;
+		SearchText search_generic_name_romanized;
+		SearchText search_comment;
+		SearchText search_command;
+		SearchText search_name_folded;
+		SearchText search_generic_name_folded;
+		std::vector<std::string> keywords;
+		std::vector<std::string> mime_types;
+		gint64 fold_time;
+	};
+
+	static void create_text(PojkMenuItem* item, const gchar* const* keywords, const gchar* const* mime_types, const Options& options, Text& text);
+
+	Launcher(PojkMenuItem* item, TokenDictionary* dictionary, const Text& text);
 	~Launcher();
 
 	enum
@@ -117,28 +155,63 @@ public:
 		return pojk_menu_item_get_uri(m_item);
 	}
 
+	PojkMenuItem* get_menu_item() const
+	{
+		return m_item;
+	}
+
+	void measure(MemoryReport& report) const;
+
+	void prefetch() const;
+
 	void run(GdkScreen* screen) const;
 
 	void run(GdkScreen* screen, DesktopAction* action) const;
 
 	guint search(const Query& query);
 
+	gchar* create_highlighted_text(const Query& query) const;
+
+	gunichar get_next_character(const Query& query) const;
+
 	enum SearchFlag
 	{
 		RecentFlag = 0x1,
 		FavoriteFlag = 0x2
 	};
+	bool get_flag(SearchFlag flag) const
+	{
+		return m_search_flags & flag;
+	}
 	void set_flag(SearchFlag flag, bool enabled);
 
+	void update_text(const Options& options);
+
+private:
+	void apply_text(const Text& text);
+	bool parse_command(GError** error) const;
+
 private:
 	PojkMenuItem* m_item;
 	const gchar* m_display_name;
-	std::string m_search_name;
-	std::string m_search_generic_name;
-	std::string m_search_comment;
-	std::string m_search_command;
+	SearchText m_search_name;
+	SearchText m_search_generic_name;
+	SearchText m_search_name_romanized;
+	SearchText m_search_generic_name_romanized;
+	SearchText m_search_comment;
+	SearchText m_search_command;
+	std::vector<guint32> m_search_keywords;
+	std::vector<guint32> m_search_mime_types;
+	const TokenDictionary* m_dictionary;
+	SearchText m_search_name_folded;
+	SearchText m_search_generic_name_folded;
+	mutable std::vector<SearchText::Span> m_name_spans;
+	mutable unsigned int m_name_spans_serial;
+	std::vector<SearchText::Span> m_speculative_spans;
+	unsigned int m_speculative_spans_serial;
 	guint m_search_flags;
 	std::vector<DesktopAction*> m_actions;
+	mutable gchar** m_argv;
 };
 
 }
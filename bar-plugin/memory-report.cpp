@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memory-report.h"
+
+#include <cstring>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+// Estimated size of a GSequence node backing each list store row
+static const gsize list_store_row_size = 5 * sizeof(gpointer);
+
+// Estimated size of a GtkTreeDataList holding each list store cell
+static const gsize list_store_cell_size = sizeof(gpointer) + sizeof(gdouble);
+
+static const gchar* const subsystem_names[MemoryReport::CountSubsystems] =
+{
+	"launchers",
+	"categories",
+	"models",
+	"search index",
+	"folded text",
+	"icons",
+	"menu tree"
+};
+
+//-----------------------------------------------------------------------------
+
+MemoryReport::MemoryReport() :
+	m_models(0),
+	m_rows(0)
+{
+	for (int i = 0; i < CountSubsystems; ++i)
+	{
+		m_bytes[i] = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void MemoryReport::add_object(Subsystem subsystem, gpointer object)
+{
+	if (!G_IS_OBJECT(object))
+	{
+		return;
+	}
+
+	GTypeQuery query;
+	g_type_query(G_OBJECT_TYPE(object), &query);
+	m_bytes[subsystem] += query.instance_size;
+}
+
+//-----------------------------------------------------------------------------
+
+void MemoryReport::add_model(Subsystem subsystem, GtkTreeModel* model)
+{
+	if (!model)
+	{
+		return;
+	}
+
+	add_object(subsystem, model);
+	++m_models;
+
+	// Virtual models fetch values from the elements, so only count the rows
+	// of list stores which hold copies of the strings
+	if (!GTK_IS_LIST_STORE(model))
+	{
+		return;
+	}
+
+	const gint columns = gtk_tree_model_get_n_columns(model);
+	GtkTreeIter iter;
+	for (bool valid = gtk_tree_model_get_iter_first(model, &iter); valid; valid = gtk_tree_model_iter_next(model, &iter))
+	{
+		m_bytes[subsystem] += list_store_row_size + (columns * list_store_cell_size);
+		++m_rows;
+
+		for (gint column = 0; column < columns; ++column)
+		{
+			if (gtk_tree_model_get_column_type(model, column) != G_TYPE_STRING)
+			{
+				continue;
+			}
+
+			gchar* string = NULL;
+			gtk_tree_model_get(model, &iter, column, &string, -1);
+			add_string(subsystem, string);
+			g_free(string);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void MemoryReport::add_pixbuf(Subsystem subsystem, GdkPixbuf* pixbuf)
+{
+	if (!pixbuf)
+	{
+		return;
+	}
+
+	add_object(subsystem, pixbuf);
+	m_bytes[subsystem] += gdk_pixbuf_get_rowstride(pixbuf) * gdk_pixbuf_get_height(pixbuf);
+}
+
+//-----------------------------------------------------------------------------
+
+void MemoryReport::add_string(Subsystem subsystem, const gchar* string)
+{
+	if (string)
+	{
+		m_bytes[subsystem] += strlen(string) + 1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void MemoryReport::print() const
+{
+	gsize total = 0;
+	for (int i = 0; i < CountSubsystems; ++i)
+	{
+		g_message("Memory: %-12s %8" G_GSIZE_FORMAT " KiB", subsystem_names[i], (m_bytes[i] + 1023) / 1024);
+		total += m_bytes[i];
+	}
+	g_message("Memory: %-12s %8" G_GSIZE_FORMAT " KiB in %u models with %u list store rows",
+			"total", (total + 1023) / 1024, m_models, m_rows);
+}
+
+//-----------------------------------------------------------------------------
+
+bool MemoryReport::requested()
+{
+	const gchar* value = g_getenv("BLADEMENU_MEMORY_REPORT");
+	return value && *value && (strcmp(value, "0") != 0);
+}
+
+//-----------------------------------------------------------------------------
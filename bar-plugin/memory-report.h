@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_MEMORY_REPORT_H
+#define BLADEMENU_MEMORY_REPORT_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtk/gtk.h>
+
+namespace BladeMenu
+{
+
+class MemoryReport
+{
+public:
+	MemoryReport();
+
+	enum Subsystem
+	{
+		Launchers = 0,
+		Categories,
+		Models,
+		SearchIndex,
+		FoldedText,
+		Icons,
+		Menu,
+		CountSubsystems
+	};
+
+	void add(Subsystem subsystem, gsize bytes)
+	{
+		m_bytes[subsystem] += bytes;
+	}
+
+	void add_object(Subsystem subsystem, gpointer object);
+	void add_model(Subsystem subsystem, GtkTreeModel* model);
+	void add_pixbuf(Subsystem subsystem, GdkPixbuf* pixbuf);
+
+	void add_string(Subsystem subsystem, const gchar* string);
+
+	void add_string(Subsystem subsystem, const std::string& string)
+	{
+		m_bytes[subsystem] += string.capacity() + 1;
+	}
+
+	template<typename T>
+	void add_vector(Subsystem subsystem, const std::vector<T>& vector)
+	{
+		m_bytes[subsystem] += vector.capacity() * sizeof(T);
+	}
+
+	template<typename K, typename V>
+	void add_map(Subsystem subsystem, const std::map<K, V>& map)
+	{
+		// Each node stores the value next to its color and three links
+		m_bytes[subsystem] += map.size() * (sizeof(typename std::map<K, V>::value_type) + (4 * sizeof(gpointer)));
+	}
+
+	gsize get_bytes(Subsystem subsystem) const
+	{
+		return m_bytes[subsystem];
+	}
+
+	void print() const;
+
+	static bool requested();
+
+private:
+	gsize m_bytes[CountSubsystems];
+	guint m_models;
+	guint m_rows;
+};
+
+}
+
+#endif // BLADEMENU_MEMORY_REPORT_H
@@ -21,6 +21,7 @@
 #include "launcher.h"
 #include "launcher-view.h"
 #include "recent-page.h"
+#include "settings.h"
 #include "slot.h"
 #include "window.h"
 
@@ -34,13 +35,15 @@ using namespace BladeMenu;
 
 Page::Page(Window* window) :
 	m_window(window),
-	m_selected_path(NULL)
+	m_selected_path(NULL),
+	m_prefetch_timeout_id(0)
 {
 	// Create view
 	m_view = new LauncherView(window);
 	g_signal_connect_slot(m_view->get_widget(), "button-press-event", &Page::view_button_press_event, this);
 	g_signal_connect_slot(m_view->get_widget(), "popup-menu", &Page::view_popup_menu_event, this);
 	g_signal_connect_slot(m_view->get_widget(), "row-activated", &Page::item_activated, this);
+	g_signal_connect_slot(gtk_tree_view_get_selection(GTK_TREE_VIEW(m_view->get_widget())), "changed", &Page::item_selected, this);
 	g_signal_connect_swapped(m_view->get_widget(), "start-interactive-search", G_CALLBACK(gtk_widget_grab_focus), m_window->get_search_entry());
 
 	// Add scrolling to view
@@ -55,6 +58,11 @@ Page::Page(Window* window) :
 
 Page::~Page()
 {
+	if (m_prefetch_timeout_id)
+	{
+		g_source_remove(m_prefetch_timeout_id);
+	}
+
 	if (m_selected_path)
 	{
 		gtk_tree_path_free(m_selected_path);
@@ -106,6 +114,12 @@ bool Page::remember_launcher(Launcher*)
 
 //-----------------------------------------------------------------------------
 
+void Page::launcher_activated(Launcher*)
+{
+}
+
+//-----------------------------------------------------------------------------
+
 void Page::item_activated(GtkTreeView* view, GtkTreePath* path, GtkTreeViewColumn*)
 {
 	GtkTreeIter iter;
@@ -128,6 +142,7 @@ void Page::item_activated(GtkTreeView* view, GtkTreePath* path, GtkTreeViewColum
 		{
 			m_window->get_recent()->add(launcher);
 		}
+		launcher_activated(launcher);
 	}
 
 	// Hide window
@@ -139,6 +154,55 @@ void Page::item_activated(GtkTreeView* view, GtkTreePath* path, GtkTreeViewColum
 
 //-----------------------------------------------------------------------------
 
+void Page::item_selected(GtkTreeSelection*)
+{
+	if (!wm_settings->launcher_prefetch)
+	{
+		return;
+	}
+
+	// Wait for the selection to settle, so that moving across the menu
+	// does not read ahead every launcher passed over
+	if (m_prefetch_timeout_id)
+	{
+		g_source_remove(m_prefetch_timeout_id);
+	}
+	m_prefetch_timeout_id = g_timeout_add(200, (GSourceFunc)&Page::prefetch_selected, this);
+}
+
+//-----------------------------------------------------------------------------
+
+gboolean Page::prefetch_selected(Page* page)
+{
+	page->m_prefetch_timeout_id = 0;
+
+	// Read ahead files of frequently used applications before activation
+	GtkTreeSelection* selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(page->m_view->get_widget()));
+	GtkTreeModel* model = NULL;
+	GtkTreeIter iter;
+	if (!gtk_tree_selection_get_selected(selection, &model, &iter))
+	{
+		return false;
+	}
+
+	Element* element = NULL;
+	gtk_tree_model_get(model, &iter, LauncherView::COLUMN_LAUNCHER, &element, -1);
+	if (!element || (element->get_type() != Launcher::Type))
+	{
+		return false;
+	}
+
+	Launcher* launcher = static_cast<Launcher*>(element);
+	if (launcher->get_flag(Launcher::FavoriteFlag) || launcher->get_flag(Launcher::RecentFlag))
+	{
+		launcher->prefetch();
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
 void Page::item_action_activated(GtkMenuItem* menuitem, DesktopAction* action)
 {
 	Launcher* launcher = get_selected_launcher();
@@ -54,7 +54,10 @@ protected:
 
 private:
 	virtual bool remember_launcher(Launcher* launcher);
+	virtual void launcher_activated(Launcher* launcher);
 	void item_activated(GtkTreeView* view, GtkTreePath* path, GtkTreeViewColumn*);
+	void item_selected(GtkTreeSelection* selection);
+	static gboolean prefetch_selected(Page* page);
 	void item_action_activated(GtkMenuItem* menuitem, DesktopAction* action);
 	gboolean view_button_press_event(GtkWidget* view, GdkEvent* event);
 	gboolean view_popup_menu_event(GtkWidget* view);
@@ -75,6 +78,7 @@ private:
 	GtkWidget* m_widget;
 	LauncherView* m_view;
 	GtkTreePath* m_selected_path;
+	guint m_prefetch_timeout_id;
 };
 
 }
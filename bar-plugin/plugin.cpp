@@ -20,6 +20,7 @@
 #include "applications-page.h"
 #include "command.h"
 #include "configuration-dialog.h"
+#include "memory-report.h"
 #include "settings.h"
 #include "slot.h"
 #include "window.h"
@@ -96,27 +97,19 @@ static bool bar_utils_grab_available()
 Plugin::Plugin(BladeBarPlugin* plugin) :
 	m_plugin(plugin),
 	m_window(NULL),
-	m_opacity(100)
+	m_opacity(100),
+	m_save_timeout_id(0)
 {
 	// Load settings
 	wm_settings = new Settings;
 	wm_settings->button_title = get_button_title_default();
-	wm_settings->load(xfce_resource_lookup(XFCE_RESOURCE_CONFIG, "xfce4/blademenu/defaults.rc"));
-	wm_settings->load(blade_bar_plugin_lookup_rc_file(m_plugin));
 	m_opacity = wm_settings->menu_opacity;
 
-	// Prevent empty bar button
-	if (!wm_settings->button_icon_visible)
-	{
-		if (!wm_settings->button_title_visible)
-		{
-			wm_settings->button_icon_visible = true;
-		}
-		else if (wm_settings->button_title.empty())
-		{
-			wm_settings->button_title = get_button_title_default();
-		}
-	}
+	// Read settings in a thread, using defaults until they are loaded
+	wm_settings->load_async(xfce_resource_lookup(XFCE_RESOURCE_CONFIG, "xfce4/blademenu/defaults.rc"),
+			blade_bar_plugin_lookup_rc_file(m_plugin),
+			blade_bar_plugin_save_location(m_plugin, false),
+			(GSourceFunc)&Plugin::settings_loaded, this);
 
 	// Create toggle button
 	m_button = blade_bar_create_toggle_button();
@@ -159,6 +152,7 @@ Plugin::Plugin(BladeBarPlugin* plugin) :
 	g_signal_connect_slot(plugin, "orientation-changed", &Plugin::orientation_changed, this);
 #endif
 	g_signal_connect_slot(plugin, "remote-event", &Plugin::remote_event, this);
+	g_signal_connect_slot<BladeBarPlugin*>(plugin, "remove", &Plugin::remove, this);
 	g_signal_connect_slot<BladeBarPlugin*>(plugin, "save", &Plugin::save, this);
 	g_signal_connect_slot<BladeBarPlugin*>(plugin, "about", &Plugin::show_about, this);
 	g_signal_connect_slot(plugin, "size-changed", &Plugin::size_changed, this);
@@ -185,6 +179,7 @@ Plugin::Plugin(BladeBarPlugin* plugin) :
 
 Plugin::~Plugin()
 {
+	// Queue any changes; deleting the settings waits for them to be written
 	save();
 
 	delete m_window;
@@ -234,6 +229,14 @@ void Plugin::reload()
 
 //-----------------------------------------------------------------------------
 
+void Plugin::update_display()
+{
+	m_window->hide();
+	m_window->get_applications()->update_display();
+}
+
+//-----------------------------------------------------------------------------
+
 void Plugin::set_button_style(ButtonStyle style)
 {
 	wm_settings->button_icon_visible = style & ShowIcon;
@@ -315,7 +318,12 @@ void Plugin::button_toggled(GtkToggleButton* button)
 void Plugin::menu_hidden()
 {
 	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(m_button), false);
-	save();
+
+	// Coalesce saves if the menu is shown repeatedly
+	if (!m_save_timeout_id)
+	{
+		m_save_timeout_id = g_timeout_add_seconds(5, (GSourceFunc)&Plugin::save_timeout, this);
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -346,6 +354,18 @@ void Plugin::orientation_changed(BladeBarPlugin*, GtkOrientation orientation)
 
 gboolean Plugin::remote_event(BladeBarPlugin*, gchar* name, GValue* value)
 {
+	if (strcmp(name, "memory-report") == 0)
+	{
+		MemoryReport report;
+		m_window->measure(report);
+		if (gtk_image_get_storage_type(m_button_icon) == GTK_IMAGE_PIXBUF)
+		{
+			report.add_pixbuf(MemoryReport::Icons, gtk_image_get_pixbuf(m_button_icon));
+		}
+		report.print();
+		return true;
+	}
+
 	if (strcmp(name, "popup") || !bar_utils_grab_available())
 	{
 		return false;
@@ -369,8 +389,24 @@ gboolean Plugin::remote_event(BladeBarPlugin*, gchar* name, GValue* value)
 
 //-----------------------------------------------------------------------------
 
+void Plugin::remove()
+{
+	// The bar deletes the settings file, but not the journal next to it
+	gchar* file = blade_bar_plugin_save_location(m_plugin, false);
+	wm_settings->remove_journal(file);
+	g_free(file);
+}
+
+//-----------------------------------------------------------------------------
+
 void Plugin::save()
 {
+	if (m_save_timeout_id)
+	{
+		g_source_remove(m_save_timeout_id);
+		m_save_timeout_id = 0;
+	}
+
 	m_window->save();
 
 	if (wm_settings->get_modified())
@@ -381,6 +417,47 @@ void Plugin::save()
 
 //-----------------------------------------------------------------------------
 
+gboolean Plugin::save_timeout(Plugin* plugin)
+{
+	plugin->m_save_timeout_id = 0;
+	plugin->save();
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
+gboolean Plugin::settings_loaded(Plugin* plugin)
+{
+	// Prevent empty bar button
+	if (!wm_settings->button_icon_visible)
+	{
+		if (!wm_settings->button_title_visible)
+		{
+			wm_settings->button_icon_visible = true;
+		}
+		else if (wm_settings->button_title.empty())
+		{
+			wm_settings->button_title = get_button_title_default();
+		}
+	}
+
+	// Update bar button; resizing loads the icon from the loaded icon name,
+	// the same as set_button_icon_name() does without marking it modified
+	gtk_widget_set_visible(GTK_WIDGET(plugin->m_button_icon), wm_settings->button_icon_visible);
+	gtk_widget_set_visible(GTK_WIDGET(plugin->m_button_label), wm_settings->button_title_visible);
+	gtk_label_set_markup(plugin->m_button_label, wm_settings->button_title.c_str());
+	plugin->update_size();
+
+	// Update menu window created from defaults
+	plugin->m_window->load_settings();
+	plugin->m_opacity = wm_settings->menu_opacity;
+	plugin->reload();
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
 void Plugin::show_about()
 {
 	const gchar* authors[] = {
@@ -450,6 +527,11 @@ gboolean Plugin::size_changed(BladeBarPlugin*, gint size)
 		icon_width = gdk_pixbuf_get_width(icon);
 		g_object_unref(G_OBJECT(icon));
 	}
+	else
+	{
+		// Do not keep showing a previous icon
+		gtk_image_clear(m_button_icon);
+	}
 
 #if (LIBBLADEBAR_CHECK_VERSION(4,9,0))
 	if (wm_settings->button_title_visible || !wm_settings->button_single_row)
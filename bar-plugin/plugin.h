@@ -54,6 +54,7 @@ public:
 	std::string get_button_icon_name() const;
 
 	void reload();
+	void update_display();
 	void set_button_style(ButtonStyle style);
 	void set_button_title(const std::string& title);
 	void set_button_icon_name(const std::string& icon);
@@ -69,7 +70,10 @@ private:
 	void orientation_changed(BladeBarPlugin*, GtkOrientation orientation);
 #endif
 	gboolean remote_event(BladeBarPlugin*, gchar* name, GValue* value);
+	void remove();
 	void save();
+	static gboolean save_timeout(Plugin* plugin);
+	static gboolean settings_loaded(Plugin* plugin);
 	void show_about();
 	gboolean size_changed(BladeBarPlugin*, gint size);
 	void update_size();
@@ -85,6 +89,7 @@ private:
 	GtkImage* m_button_icon;
 
 	int m_opacity;
+	guint m_save_timeout_id;
 };
 
 }
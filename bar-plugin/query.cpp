@@ -28,20 +28,26 @@ using namespace BladeMenu;
 
 //-----------------------------------------------------------------------------
 
-static inline bool is_start_word(const std::string& string, std::string::size_type pos)
-{
-	return (pos == 0) || g_unichar_isspace(g_utf8_get_char(g_utf8_prev_char(&string.at(pos))));
-}
+// Identifies the query that match spans were recorded for
+static unsigned int query_serial = 0;
 
 //-----------------------------------------------------------------------------
 
-Query::Query()
+Query::Query() :
+	m_signature(0),
+	m_folded_signature(0),
+	m_serial(++query_serial),
+	m_speculative(false)
 {
 }
 
 //-----------------------------------------------------------------------------
 
-Query::Query(const std::string& query)
+Query::Query(const std::string& query) :
+	m_signature(0),
+	m_folded_signature(0),
+	m_serial(0),
+	m_speculative(false)
 {
 	set(query);
 }
@@ -55,61 +61,76 @@ Query::~Query()
 
 //-----------------------------------------------------------------------------
 
-unsigned int Query::match(const std::string& haystack) const
+unsigned int Query::match(const SearchText& haystack, std::vector<SearchText::Span>* spans) const
+{
+	if (spans)
+	{
+		spans->clear();
+	}
+
+	// Every kind of match needs all characters of the query, so reject
+	// haystacks that are missing any of them before searching
+	if (!haystack.may_contain(m_signature))
+	{
+		return UINT_MAX;
+	}
+	return match(haystack, m_query, m_query_words, spans);
+}
+
+//-----------------------------------------------------------------------------
+
+unsigned int Query::match_folded(const SearchText& haystack) const
+{
+	if (!haystack.may_contain(m_folded_signature))
+	{
+		return UINT_MAX;
+	}
+
+	// Folded query is only stored if it differs from query
+	if (m_folded_query.empty())
+	{
+		return match(haystack, m_query, m_query_words, NULL);
+	}
+	return match(haystack, m_folded_query, m_folded_query_words, NULL);
+}
+
+//-----------------------------------------------------------------------------
+
+unsigned int Query::match(const SearchText& text, const std::string& query, const WordMatcher& query_words, std::vector<SearchText::Span>* spans)
 {
 	// Make sure haystack is longer than query
-	if (m_query.empty() || (m_query.length() > haystack.length()))
+	const std::string& haystack = text.str();
+	if (query.empty() || (query.length() > haystack.length()))
 	{
 		return UINT_MAX;
 	}
 
+	// Report where the query was found
+	std::string::size_type pos = haystack.find(query);
+	if (spans && (pos != std::string::npos))
+	{
+		SearchText::Span span = { pos, pos + query.length() };
+		spans->push_back(span);
+	}
+
 	// Check if haystack begins with or is query
-	std::string::size_type pos = haystack.find(m_query);
 	if (pos == 0)
 	{
-		return (haystack.length() == m_query.length()) ? 0x4 : 0x8;
+		return (haystack.length() == query.length()) ? 0x4 : 0x8;
 	}
 	// Check if haystack contains query starting at a word boundary
-	else if ((pos != std::string::npos) && is_start_word(haystack, pos))
+	else if ((pos != std::string::npos) && text.is_word_start(pos))
 	{
 		return 0x10;
 	}
 
-	if (m_query_words.size() > 1)
+	// Check if haystack contains query as words in order or in any order
+	if (query_words.size() > 1)
 	{
-		// Check if haystack contains query as words
-		std::string::size_type search_pos = 0;
-		for (std::vector<std::string>::const_iterator i = m_query_words.begin(), end = m_query_words.end(); i != end; ++i)
-		{
-			search_pos = haystack.find(*i, search_pos);
-			if ((search_pos == std::string::npos) || !is_start_word(haystack, search_pos))
-			{
-				search_pos = std::string::npos;
-				break;
-			}
-		}
-		if (search_pos != std::string::npos)
-		{
-			return 0x20;
-		}
-
-		// Check if haystack contains query as words in any order
-		std::vector<std::string>::size_type found_words = 0;
-		for (std::vector<std::string>::const_iterator i = m_query_words.begin(), end = m_query_words.end(); i != end; ++i)
+		unsigned int result = query_words.match(text, (spans && (pos == std::string::npos)) ? spans : NULL);
+		if (result != UINT_MAX)
 		{
-			search_pos = haystack.find(*i);
-			if ((search_pos != std::string::npos) && is_start_word(haystack, search_pos))
-			{
-				++found_words;
-			}
-			else
-			{
-				break;
-			}
-		}
-		if (found_words == m_query_words.size())
-		{
-			return 0x40;
+			return result;
 		}
 	}
 
@@ -119,31 +140,44 @@ unsigned int Query::match(const std::string& haystack) const
 		return 0x80;
 	}
 
-	// Check if haystack contains query as characters
+	// Check if haystack contains query as characters, comparing the bytes of
+	// each character and taking word boundaries from the text's offsets
 	bool characters_start_words = true;
-	bool start_word = true;
 	bool started = false;
-	const gchar* query_string = m_query.c_str();
-	for (const gchar* pos = haystack.c_str(); *pos; pos = g_utf8_next_char(pos))
+	const gchar* query_string = query.c_str();
+	const gchar* haystack_string = haystack.c_str();
+	const std::vector<guint16>& word_starts = text.get_word_starts();
+	std::vector<guint16>::const_iterator word_start = word_starts.begin(), word_starts_end = word_starts.end();
+	for (const gchar* pos = haystack_string; *pos && *query_string; pos = g_utf8_next_char(pos))
 	{
-		gunichar c = g_utf8_get_char(pos);
-		if (c == g_utf8_get_char(query_string))
-		{
-			if (start_word || started)
-			{
-				characters_start_words &= start_word;
-				query_string = g_utf8_next_char(query_string);
-				started = true;
-			}
-			start_word = false;
-		}
-		else if (g_unichar_isspace(c))
+		const std::string::size_type offset = pos - haystack_string;
+		while ((word_start != word_starts_end) && (*word_start < offset))
 		{
-			start_word = true;
+			++word_start;
 		}
-		else
+		const bool start_word = (word_start != word_starts_end) && (*word_start == offset);
+
+		const gsize length = g_utf8_next_char(query_string) - query_string;
+		if ((start_word || started) && (strncmp(pos, query_string, length) == 0))
 		{
-			start_word = false;
+			characters_start_words &= start_word;
+			query_string += length;
+			started = true;
+
+			// Report consecutive characters as one span
+			if (!spans)
+			{
+				continue;
+			}
+			if (!spans->empty() && (spans->back().end == offset))
+			{
+				spans->back().end += length;
+			}
+			else
+			{
+				SearchText::Span span = { offset, offset + length };
+				spans->push_back(span);
+			}
 		}
 	}
 	unsigned int result = UINT_MAX;
@@ -151,6 +185,10 @@ unsigned int Query::match(const std::string& haystack) const
 	{
 		result = characters_start_words ? 0x100 : 0x200;
 	}
+	else if (spans)
+	{
+		spans->clear();
+	}
 
 	return result;
 }
@@ -162,6 +200,11 @@ void Query::clear()
 	m_raw_query.clear();
 	m_query.clear();
 	m_query_words.clear();
+	m_folded_query.clear();
+	m_folded_query_words.clear();
+	m_signature = 0;
+	m_folded_signature = 0;
+	m_serial = ++query_serial;
 }
 
 //-----------------------------------------------------------------------------
@@ -170,6 +213,11 @@ void Query::set(const std::string& query)
 {
 	m_query.clear();
 	m_query_words.clear();
+	m_folded_query.clear();
+	m_folded_query_words.clear();
+	m_signature = 0;
+	m_folded_signature = 0;
+	m_serial = ++query_serial;
 
 	m_raw_query = query;
 	if (m_raw_query.empty())
@@ -182,13 +230,86 @@ void Query::set(const std::string& query)
 	m_query = utf8;
 	g_free(utf8);
 	g_free(normalized);
+	m_signature = SearchText::signature(m_query);
+	m_folded_signature = m_signature;
 
+	std::vector<std::string> words;
 	std::string buffer;
 	std::stringstream ss(m_query);
 	while (ss >> buffer)
 	{
-		m_query_words.push_back(buffer);
+		words.push_back(buffer);
+	}
+	m_query_words.set_words(words);
+
+	// Create accent-insensitive query
+	m_folded_query = fold(m_query);
+	if (!m_folded_query.empty())
+	{
+		m_folded_signature = SearchText::signature(m_folded_query);
+
+		words.clear();
+		std::stringstream folded_ss(m_folded_query);
+		while (folded_ss >> buffer)
+		{
+			words.push_back(buffer);
+		}
+		m_folded_query_words.set_words(words);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+std::string Query::fold(const std::string& string)
+{
+	std::string result;
+
+	// Skip strings that cannot contain diacritics
+	const gchar* pos = string.c_str();
+	for (; *pos; ++pos)
+	{
+		if (static_cast<guchar>(*pos) >= 0x80)
+		{
+			break;
+		}
+	}
+	if (!*pos)
+	{
+		return result;
+	}
+
+	// Decompose into base characters and marks
+	gchar* decomposed = g_utf8_normalize(string.c_str(), -1, G_NORMALIZE_ALL);
+	if (G_UNLIKELY(!decomposed))
+	{
+		return result;
 	}
+
+	// Strip marks
+	result.reserve(strlen(decomposed));
+	for (const gchar* c = decomposed; *c; c = g_utf8_next_char(c))
+	{
+		switch (g_unichar_type(g_utf8_get_char(c)))
+		{
+		case G_UNICODE_SPACING_MARK:
+		case G_UNICODE_ENCLOSING_MARK:
+		case G_UNICODE_NON_SPACING_MARK:
+			break;
+
+		default:
+			result.append(c, g_utf8_next_char(c) - c);
+			break;
+		}
+	}
+	g_free(decomposed);
+
+	// Only keep folded string if it differs
+	if (result == string)
+	{
+		result.clear();
+	}
+
+	return result;
 }
 
 //-----------------------------------------------------------------------------
@@ -18,6 +18,9 @@
 #ifndef BLADEMENU_QUERY_H
 #define BLADEMENU_QUERY_H
 
+#include "search-text.h"
+#include "word-matcher.h"
+
 #include <string>
 #include <vector>
 
@@ -36,7 +39,13 @@ public:
 		return m_query.empty();
 	}
 
-	unsigned int match(const std::string& haystack) const;
+	bool has_diacritics() const
+	{
+		return !m_folded_query.empty();
+	}
+
+	unsigned int match(const SearchText& haystack, std::vector<SearchText::Span>* spans = NULL) const;
+	unsigned int match_folded(const SearchText& haystack) const;
 
 	const std::string& query() const
 	{
@@ -48,13 +57,40 @@ public:
 		return m_raw_query;
 	}
 
+	unsigned int get_serial() const
+	{
+		return m_serial;
+	}
+
+	// Speculative queries record match spans apart from the shown query
+	bool get_speculative() const
+	{
+		return m_speculative;
+	}
+
+	void set_speculative(bool speculative)
+	{
+		m_speculative = speculative;
+	}
+
 	void clear();
 	void set(const std::string& query);
 
+	static std::string fold(const std::string& string);
+
+private:
+	static unsigned int match(const SearchText& text, const std::string& query, const WordMatcher& query_words, std::vector<SearchText::Span>* spans);
+
 private:
 	std::string m_raw_query;
 	std::string m_query;
-	std::vector<std::string> m_query_words;
+	WordMatcher m_query_words;
+	std::string m_folded_query;
+	WordMatcher m_folded_query_words;
+	guint64 m_signature;
+	guint64 m_folded_signature;
+	unsigned int m_serial;
+	bool m_speculative;
 };
 
 }
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "reload-coordinator.h"
+
+#include "applications-page.h"
+
+#include <glib/gstdio.h>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+// Time without notifications before a batch is processed
+static const gint64 quiet_period = 1 * G_USEC_PER_SEC;
+
+//-----------------------------------------------------------------------------
+
+static void read_file_state(const std::string& path, ReloadCoordinator::FileState& state)
+{
+	// Compare modification times to the nanosecond, since desktop files
+	// can be rewritten more than once in the same second
+	GStatBuf buf;
+	state.exists = g_stat(path.c_str(), &buf) == 0;
+	if (state.exists)
+	{
+		state.mtime = (gint64(buf.st_mtim.tv_sec) * G_GINT64_CONSTANT(1000000000)) + buf.st_mtim.tv_nsec;
+		state.inode = buf.st_ino;
+		state.size = buf.st_size;
+	}
+	else
+	{
+		state.mtime = 0;
+		state.inode = 0;
+		state.size = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+ReloadCoordinator::ReloadCoordinator(ApplicationsPage* page) :
+	m_page(page),
+	m_timeout_id(0),
+	m_last_notification(0),
+	m_batch_size(0),
+	m_menu_changed(false),
+	m_notifications(0),
+	m_coalesced(0),
+	m_skipped(0),
+	m_reloads(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+
+ReloadCoordinator::~ReloadCoordinator()
+{
+	if (m_timeout_id)
+	{
+		g_source_remove(m_timeout_id);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void ReloadCoordinator::track(Files& files, const gchar* path)
+{
+	if (path)
+	{
+		read_file_state(path, files[path]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void ReloadCoordinator::swap_files(Files& files)
+{
+	m_files.swap(files);
+}
+
+//-----------------------------------------------------------------------------
+
+void ReloadCoordinator::file_changed(GFileMonitor*, GFile* file, GFile*, GFileMonitorEvent)
+{
+	// Files that were not loaded are new applications or folders
+	gchar* path = g_file_get_path(file);
+	if (path && (m_files.find(path) != m_files.end()))
+	{
+		m_changed.insert(path);
+		notify();
+	}
+	else
+	{
+		menu_changed();
+	}
+	g_free(path);
+}
+
+//-----------------------------------------------------------------------------
+
+void ReloadCoordinator::item_changed(PojkMenuItem* item)
+{
+	GFile* file = pojk_menu_item_get_file(item);
+	gchar* path = file ? g_file_get_path(file) : NULL;
+	if (file)
+	{
+		g_object_unref(file);
+	}
+	if (path)
+	{
+		m_changed.insert(path);
+		g_free(path);
+		notify();
+	}
+	else
+	{
+		menu_changed();
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void ReloadCoordinator::menu_changed()
+{
+	m_menu_changed = true;
+	notify();
+}
+
+//-----------------------------------------------------------------------------
+
+void ReloadCoordinator::notify()
+{
+	++m_notifications;
+	++m_batch_size;
+	m_last_notification = g_get_monotonic_time();
+
+	if (!m_timeout_id)
+	{
+		m_timeout_id = g_timeout_add(quiet_period / 1000, (GSourceFunc)&ReloadCoordinator::quiet_timeout, this);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+bool ReloadCoordinator::files_changed() const
+{
+	// Only check the files that notifications were sent for
+	for (std::set<std::string>::const_iterator i = m_changed.begin(), end = m_changed.end(); i != end; ++i)
+	{
+		std::map<std::string, FileState>::const_iterator loaded = m_files.find(*i);
+		if (loaded == m_files.end())
+		{
+			return true;
+		}
+
+		FileState state;
+		read_file_state(*i, state);
+		if ((state.exists != loaded->second.exists)
+				|| (state.mtime != loaded->second.mtime)
+				|| (state.inode != loaded->second.inode)
+				|| (state.size != loaded->second.size))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
+void ReloadCoordinator::finish_batch()
+{
+	m_coalesced += m_batch_size - 1;
+
+	// Menu structure changes always reload, while item changes only reload
+	// if a desktop file is different from when it was loaded
+	if (m_menu_changed || files_changed())
+	{
+		++m_reloads;
+		m_page->invalidate_applications();
+	}
+	else
+	{
+		++m_skipped;
+	}
+
+	g_debug("Reload: %u notifications, %u coalesced, %u skipped, %u reloads",
+			m_notifications, m_coalesced, m_skipped, m_reloads);
+
+	m_batch_size = 0;
+	m_menu_changed = false;
+	m_changed.clear();
+}
+
+//-----------------------------------------------------------------------------
+
+gboolean ReloadCoordinator::quiet_timeout(ReloadCoordinator* coordinator)
+{
+	// Wait until notifications stop arriving
+	const gint64 remaining = (coordinator->m_last_notification + quiet_period) - g_get_monotonic_time();
+	if (remaining > 0)
+	{
+		coordinator->m_timeout_id = g_timeout_add((remaining / 1000) + 1, (GSourceFunc)&ReloadCoordinator::quiet_timeout, coordinator);
+		return false;
+	}
+
+	coordinator->m_timeout_id = 0;
+	coordinator->finish_batch();
+	return false;
+}
+
+//-----------------------------------------------------------------------------
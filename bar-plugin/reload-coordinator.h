@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_RELOAD_COORDINATOR_H
+#define BLADEMENU_RELOAD_COORDINATOR_H
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <pojk/pojk.h>
+
+namespace BladeMenu
+{
+
+class ApplicationsPage;
+
+class ReloadCoordinator
+{
+public:
+	explicit ReloadCoordinator(ApplicationsPage* page);
+	~ReloadCoordinator();
+
+	guint get_notifications() const
+	{
+		return m_notifications;
+	}
+
+	guint get_coalesced() const
+	{
+		return m_coalesced;
+	}
+
+	guint get_skipped() const
+	{
+		return m_skipped;
+	}
+
+	guint get_reloads() const
+	{
+		return m_reloads;
+	}
+
+	struct FileState
+	{
+		gint64 mtime;
+		guint64 inode;
+		gint64 size;
+		bool exists;
+	};
+	typedef std::map<std::string, FileState> Files;
+
+	static void track(Files& files, const gchar* path);
+	void swap_files(Files& files);
+
+	void file_changed(GFileMonitor* monitor, GFile* file, GFile* other_file, GFileMonitorEvent event);
+	void item_changed(PojkMenuItem* item);
+	void menu_changed();
+
+private:
+	void notify();
+	bool files_changed() const;
+	void finish_batch();
+	static gboolean quiet_timeout(ReloadCoordinator* coordinator);
+
+private:
+	ApplicationsPage* m_page;
+	Files m_files;
+	std::set<std::string> m_changed;
+
+	guint m_timeout_id;
+	gint64 m_last_notification;
+	guint m_batch_size;
+	bool m_menu_changed;
+
+	guint m_notifications;
+	guint m_coalesced;
+	guint m_skipped;
+	guint m_reloads;
+};
+
+}
+
+#endif // BLADEMENU_RELOAD_COORDINATOR_H
@@ -19,6 +19,7 @@
 
 #include "query.h"
 #include "settings.h"
+#include "spawner.h"
 
 #include <libbladeui/libbladeui.h>
 
@@ -36,7 +37,7 @@ RunAction::RunAction()
 void RunAction::run(GdkScreen* screen) const
 {
 	GError* error = NULL;
-	if (xfce_spawn_command_line_on_screen(screen, m_command_line.c_str(), false, false, &error) == false)
+	if (Spawner::run(screen, m_command_line.c_str(), &error) == false)
 	{
 		xfce_dialog_show_error(NULL, error, _("Failed to execute command \"%s\"."), m_command_line.c_str());
 		g_error_free(error);
@@ -53,7 +54,7 @@ guint RunAction::search(const Query& query)
 	gchar** argv;
 	if (g_shell_parse_argv(query.raw_query().c_str(), NULL, &argv, NULL))
 	{
-		gchar* path = g_find_program_in_path(argv[0]);
+		gchar* path = Spawner::find_program(argv[0]);
 		valid = path != NULL;
 		g_free(path);
 		g_strfreev(argv);
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "search-action-dispatcher.h"
+
+#include "search-action.h"
+
+#include <algorithm>
+
+#include <cstring>
+
+#include <glib.h>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+void SearchActionDispatcher::clear()
+{
+	m_nodes.clear();
+	m_actions.clear();
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchActionDispatcher::find(const std::string& query, std::vector<SearchAction*>& actions) const
+{
+	actions.clear();
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	// Collect actions whose prefix is a prefix of the query
+	std::vector<std::vector<SearchAction*>::size_type> found;
+	std::vector<Node>::size_type node = 0;
+	for (std::string::size_type i = 0; ; ++i)
+	{
+		const Node& current = m_nodes[node];
+		found.insert(found.end(), current.actions.begin(), current.actions.end());
+
+		if (i == query.length())
+		{
+			break;
+		}
+
+		std::map<unsigned char, std::vector<Node>::size_type>::const_iterator child = current.children.find(query[i]);
+		if (child == current.children.end())
+		{
+			break;
+		}
+		node = child->second;
+	}
+
+	// Keep order of actions in settings
+	std::sort(found.begin(), found.end());
+	actions.reserve(found.size());
+	for (std::vector<std::vector<SearchAction*>::size_type>::const_iterator i = found.begin(), end = found.end(); i != end; ++i)
+	{
+		actions.push_back(m_actions[*i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchActionDispatcher::set_actions(const std::vector<SearchAction*>& actions)
+{
+	clear();
+	m_actions = actions;
+	m_nodes.push_back(Node());
+
+	for (std::vector<SearchAction*>::size_type i = 0, end = m_actions.size(); i < end; ++i)
+	{
+		const std::string prefix = required_prefix(m_actions[i]);
+
+		std::vector<Node>::size_type node = 0;
+		for (std::string::size_type j = 0, length = prefix.length(); j < length; ++j)
+		{
+			const unsigned char c = prefix[j];
+			std::map<unsigned char, std::vector<Node>::size_type>::const_iterator child = m_nodes[node].children.find(c);
+			if (child != m_nodes[node].children.end())
+			{
+				node = child->second;
+			}
+			else
+			{
+				m_nodes.push_back(Node());
+				m_nodes[node].children[c] = m_nodes.size() - 1;
+				node = m_nodes.size() - 1;
+			}
+		}
+		m_nodes[node].actions.push_back(i);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+std::string SearchActionDispatcher::required_prefix(const SearchAction* action)
+{
+	const std::string pattern = action->get_pattern();
+	if (!action->get_is_regex())
+	{
+		return pattern;
+	}
+
+	// Only anchored expressions without alternation have a required prefix
+	if (pattern.empty() || (pattern[0] != '^') || (pattern.find('|') != std::string::npos))
+	{
+		return std::string();
+	}
+
+	std::string prefix;
+	for (std::string::size_type i = 1, length = pattern.length(); i < length; ++i)
+	{
+		char c = pattern[i];
+		if (c == '\\')
+		{
+			// Escaped letters and digits are classes or references
+			if ((i + 1 == length) || g_ascii_isalnum(pattern[i + 1]) || !g_ascii_isprint(pattern[i + 1]))
+			{
+				break;
+			}
+			c = pattern[++i];
+		}
+		else if (!g_ascii_isprint(c) || strchr(".[()*+?{$^", c))
+		{
+			break;
+		}
+
+		// Quantifiers can make the last character optional
+		const char next = (i + 1 < length) ? pattern[i + 1] : '\0';
+		if ((next == '*') || (next == '?') || (next == '{'))
+		{
+			break;
+		}
+
+		prefix += c;
+
+		if (next == '+')
+		{
+			break;
+		}
+	}
+
+	return prefix;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_SEARCH_ACTION_DISPATCHER_H
+#define BLADEMENU_SEARCH_ACTION_DISPATCHER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace BladeMenu
+{
+
+class SearchAction;
+
+class SearchActionDispatcher
+{
+public:
+	void clear();
+	void find(const std::string& query, std::vector<SearchAction*>& actions) const;
+	void set_actions(const std::vector<SearchAction*>& actions);
+
+	static std::string required_prefix(const SearchAction* action);
+
+private:
+	struct Node
+	{
+		std::map<unsigned char, std::vector<Node>::size_type> children;
+		std::vector<std::vector<SearchAction*>::size_type> actions;
+	};
+	std::vector<Node> m_nodes;
+	std::vector<SearchAction*> m_actions;
+};
+
+}
+
+#endif // BLADEMENU_SEARCH_ACTION_DISPATCHER_H
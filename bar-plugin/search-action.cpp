@@ -19,6 +19,7 @@
 
 #include "query.h"
 #include "settings.h"
+#include "spawner.h"
 
 #include <libbladeui/libbladeui.h>
 
@@ -43,6 +44,7 @@ SearchAction::SearchAction(const gchar* name, const gchar* pattern, const gchar*
 	m_command(command ? command : ""),
 	m_is_regex(is_regex),
 	m_show_description(show_description),
+	m_template(m_command.c_str()),
 	m_regex(NULL)
 {
 	set_icon("folder-saved-search");
@@ -68,8 +70,6 @@ guint SearchAction::search(const Query& query)
 		return false;
 	}
 
-	m_expanded_command.clear();
-
 	const gchar* haystack = query.raw_query().c_str();
 	guint found = !m_is_regex ? match_prefix(haystack) : match_regex(haystack);
 
@@ -91,97 +91,111 @@ guint SearchAction::match_prefix(const gchar* haystack)
 		return G_MAXUINT;
 	}
 
-	gchar* trimmed = g_strdup(haystack + m_pattern.length());
-	trimmed = g_strstrip(trimmed);
+	// The command is only expanded if the action is run
+	m_haystack.assign(haystack);
 
-	gchar* uri = NULL;
+	return m_pattern.length();
+}
+
+//-----------------------------------------------------------------------------
 
-	m_expanded_command = m_command;
-	std::string::size_type pos = 0, lastpos = m_expanded_command.length() - 1;
-	while ((pos = m_expanded_command.find('%', pos)) != std::string::npos)
+guint SearchAction::match_regex(const gchar* haystack)
+{
+	if (!m_regex)
 	{
-		if (pos == lastpos)
+		// Skip actions whose command has invalid references
+		if (!g_regex_check_replacement(m_command.c_str(), NULL, NULL))
 		{
-			break;
+			return G_MAXUINT;
 		}
 
-		switch (m_expanded_command[pos + 1])
+		m_regex = g_regex_new(m_pattern.c_str(), G_REGEX_OPTIMIZE, GRegexMatchFlags(0), NULL);
+		if (!m_regex)
 		{
-		case 's':
-			m_expanded_command.replace(pos, 2, trimmed);
-			pos += strlen(trimmed) + 1;
-			break;
-
-		case 'S':
-			m_expanded_command.replace(pos, 2, haystack);
-			pos += strlen(haystack) + 1;
-			break;
-
-		case 'u':
-			if (!uri)
-			{
-				uri = g_uri_escape_string(trimmed, NULL, true);
-			}
-			m_expanded_command.replace(pos, 2, uri);
-			pos += strlen(uri) + 1;
-			break;
-
-		case '%':
-			m_expanded_command.erase(pos, 1);
-			pos += 1;
-			break;
-
-		default:
-			m_expanded_command.erase(pos, 2);
-			break;
+			return G_MAXUINT;
 		}
 	}
 
-	g_free(trimmed);
-	g_free(uri);
+	if (!g_regex_match(m_regex, haystack, GRegexMatchFlags(0), NULL))
+	{
+		return G_MAXUINT;
+	}
+
+	// The command is only expanded if the action is run
+	m_haystack.assign(haystack);
 
 	return m_pattern.length();
 }
 
 //-----------------------------------------------------------------------------
 
-guint SearchAction::match_regex(const gchar* haystack)
+bool SearchAction::expand_command() const
 {
-	guint found = G_MAXUINT;
+	m_expanded_command.clear();
 
-	if (!m_regex)
+	if (m_is_regex)
 	{
-		m_regex = g_regex_new(m_pattern.c_str(), G_REGEX_OPTIMIZE, GRegexMatchFlags(0), NULL);
 		if (!m_regex)
 		{
-			return found;
+			return false;
 		}
-	}
-	GMatchInfo* match = NULL;
-	if (g_regex_match(m_regex, haystack, GRegexMatchFlags(0), &match))
-	{
-		gchar* expanded = g_match_info_expand_references(match, m_command.c_str(), NULL);
-		if (expanded)
+
+		GMatchInfo* match = NULL;
+		if (g_regex_match(m_regex, m_haystack.c_str(), GRegexMatchFlags(0), &match))
 		{
-			m_expanded_command = expanded;
-			g_free(expanded);
-			found = m_pattern.length();
+			gchar* expanded = g_match_info_expand_references(match, m_command.c_str(), NULL);
+			if (expanded)
+			{
+				m_expanded_command = expanded;
+				g_free(expanded);
+			}
+		}
+		if (match != NULL)
+		{
+			g_match_info_free(match);
 		}
+
+		return !m_expanded_command.empty();
 	}
-	if (match != NULL)
+
+	if (!g_str_has_prefix(m_haystack.c_str(), m_pattern.c_str()))
 	{
-		g_match_info_free(match);
+		return false;
 	}
 
-	return found;
+	gchar* trimmed = g_strdup(m_haystack.c_str() + m_pattern.length());
+	trimmed = g_strstrip(trimmed);
+
+	const gchar* values[CommandTemplate::CountFields] = { NULL };
+	values[CommandTemplate::FieldText] = trimmed;
+	values[CommandTemplate::FieldRawText] = m_haystack.c_str();
+
+	gchar* uri = NULL;
+	if (m_template.has_field(CommandTemplate::FieldUri))
+	{
+		uri = g_uri_escape_string(trimmed, NULL, true);
+		values[CommandTemplate::FieldUri] = uri;
+	}
+
+	m_template.expand(values, m_expanded_command);
+
+	g_free(trimmed);
+	g_free(uri);
+
+	return true;
 }
 
 //-----------------------------------------------------------------------------
 
 void SearchAction::run(GdkScreen* screen) const
 {
+	if (!expand_command())
+	{
+		return;
+	}
+
 	GError* error = NULL;
-	gboolean result = xfce_spawn_command_line_on_screen(screen, m_expanded_command.c_str(), FALSE, FALSE, &error);
+	bool result = Spawner::run(screen, m_expanded_command.c_str(), &error);
 
 	if (G_UNLIKELY(!result))
 	{
@@ -235,7 +249,14 @@ void SearchAction::set_command(const gchar* command)
 	}
 
 	m_command = command;
+	m_template.set(command);
 	wm_settings->set_modified();
+
+	if (m_regex)
+	{
+		g_regex_unref(m_regex);
+		m_regex = NULL;
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -18,6 +18,7 @@
 #ifndef BLADEMENU_SEARCH_ACTION_H
 #define BLADEMENU_SEARCH_ACTION_H
 
+#include "command-template.h"
 #include "element.h"
 
 #include <string>
@@ -70,6 +71,7 @@ public:
 	void set_is_regex(bool is_regex);
 
 private:
+	bool expand_command() const;
 	guint match_prefix(const gchar* haystack);
 	guint match_regex(const gchar* haystack);
 	void update_text();
@@ -81,7 +83,9 @@ private:
 	bool m_is_regex;
 	bool m_show_description;
 
-	std::string m_expanded_command;
+	CommandTemplate m_template;
+	std::string m_haystack;
+	mutable std::string m_expanded_command;
 	GRegex* m_regex;
 };
 
@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "search-history.h"
+
+#include <algorithm>
+
+#include <cmath>
+#include <cstring>
+
+#include <libbladeutil/libbladeutil.h>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+// Longest prefix of a query that is remembered, in bytes
+static const std::string::size_type max_prefix_length = 16;
+
+// Launchers remembered for each prefix
+static const unsigned int max_entries = 4;
+
+// Decay of a score each time any launcher is activated from a search
+static const float decay = 0.95f;
+
+// Scores below this are forgotten
+static const float min_score = 0.1f;
+
+// Score needed to boost a launcher, which takes a few activations
+static const float boost_score = 1.5f;
+
+//-----------------------------------------------------------------------------
+
+static bool compare_scores(const std::pair<float, std::string>& lhs, const std::pair<float, std::string>& rhs)
+{
+	return lhs.first > rhs.first;
+}
+
+//-----------------------------------------------------------------------------
+
+SearchHistory::SearchHistory() :
+	m_time(0),
+	m_load_thread(NULL),
+	m_file(NULL)
+{
+	m_nodes.push_back(Node());
+
+	// Read history before the first search, without blocking startup
+	m_load_thread = g_thread_new("blademenu-history", &SearchHistory::load_thread, this);
+}
+
+//-----------------------------------------------------------------------------
+
+SearchHistory::~SearchHistory()
+{
+	load();
+	g_free(m_file);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchHistory::add(const std::string& query, const gchar* desktop_id)
+{
+	if (query.empty() || !desktop_id)
+	{
+		return;
+	}
+
+	load();
+	++m_time;
+
+	// Count activation for every prefix of the query that ends on a character
+	const std::string::size_type length = std::min(query.length(), max_prefix_length);
+	const gchar* start = query.c_str();
+	for (const gchar* pos = start; *pos;)
+	{
+		pos = g_utf8_next_char(pos);
+		if (std::string::size_type(pos - start) > length)
+		{
+			break;
+		}
+		insert(std::string(start, pos), desktop_id, 1.0f);
+	}
+
+	save();
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchHistory::find(const std::string& query, std::vector<std::string>& desktop_ids)
+{
+	desktop_ids.clear();
+	if (query.empty() || (query.length() > max_prefix_length))
+	{
+		return;
+	}
+
+	load();
+
+	// Walk the trie along the query
+	std::vector<Node>::size_type node = 0;
+	for (std::string::size_type i = 0, length = query.length(); i < length; ++i)
+	{
+		std::map<unsigned char, std::vector<Node>::size_type>::const_iterator child = m_nodes[node].children.find(query[i]);
+		if (child == m_nodes[node].children.end())
+		{
+			return;
+		}
+		node = child->second;
+	}
+
+	// Return launchers used often enough for this query, best first
+	std::vector<std::pair<float, std::string> > found;
+	for (std::vector<Entry>::const_iterator i = m_nodes[node].entries.begin(), end = m_nodes[node].entries.end(); i != end; ++i)
+	{
+		float score = get_score(*i);
+		if (score >= boost_score)
+		{
+			found.push_back(std::make_pair(score, i->desktop_id));
+		}
+	}
+	std::stable_sort(found.begin(), found.end(), &compare_scores);
+	for (std::vector<std::pair<float, std::string> >::const_iterator i = found.begin(), end = found.end(); i != end; ++i)
+	{
+		desktop_ids.push_back(i->second);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+float SearchHistory::get_score(const Entry& entry) const
+{
+	return entry.score * std::pow(decay, static_cast<float>(m_time - entry.time));
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchHistory::insert(const std::string& prefix, const std::string& desktop_id, float score)
+{
+	std::vector<Node>::size_type node = 0;
+	for (std::string::size_type i = 0, length = prefix.length(); i < length; ++i)
+	{
+		const unsigned char c = prefix[i];
+		std::map<unsigned char, std::vector<Node>::size_type>::const_iterator child = m_nodes[node].children.find(c);
+		if (child != m_nodes[node].children.end())
+		{
+			node = child->second;
+		}
+		else
+		{
+			m_nodes.push_back(Node());
+			m_nodes[node].children[c] = m_nodes.size() - 1;
+			node = m_nodes.size() - 1;
+		}
+	}
+
+	// Add to score of launcher, or replace the lowest scoring launcher
+	std::vector<Entry>& entries = m_nodes[node].entries;
+	std::vector<Entry>::iterator lowest = entries.end();
+	float lowest_score = G_MAXFLOAT;
+	for (std::vector<Entry>::iterator i = entries.begin(), end = entries.end(); i != end; ++i)
+	{
+		float entry_score = get_score(*i);
+		if (i->desktop_id == desktop_id)
+		{
+			i->score = entry_score + score;
+			i->time = m_time;
+			return;
+		}
+		else if (entry_score < lowest_score)
+		{
+			lowest = i;
+			lowest_score = entry_score;
+		}
+	}
+
+	Entry entry = { desktop_id, score, m_time };
+	if (entries.size() < max_entries)
+	{
+		entries.push_back(entry);
+	}
+	else if (lowest_score < score)
+	{
+		*lowest = entry;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchHistory::load()
+{
+	// Wait for history to be read, which is usually long finished
+	if (m_load_thread)
+	{
+		g_thread_join(m_load_thread);
+		m_load_thread = NULL;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+gpointer SearchHistory::load_thread(gpointer data)
+{
+	// Only this thread uses the history until load() joins it
+	static_cast<SearchHistory*>(data)->read();
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchHistory::read()
+{
+	m_file = xfce_resource_save_location(XFCE_RESOURCE_CACHE, "blademenu/search-history", true);
+	if (!m_file)
+	{
+		return;
+	}
+
+	gchar* contents = NULL;
+	if (!g_file_get_contents(m_file, &contents, NULL, NULL))
+	{
+		return;
+	}
+
+	// Each line is an escaped prefix, a desktop id, and a score
+	gchar** lines = g_strsplit(contents, "\n", -1);
+	for (gchar** line = lines; *line; ++line)
+	{
+		gchar** fields = g_strsplit(*line, "\t", 3);
+		if (g_strv_length(fields) == 3)
+		{
+			gchar* prefix = g_strcompress(fields[0]);
+			float score = g_ascii_strtod(fields[2], NULL);
+			if ((score >= min_score) && (strlen(prefix) <= max_prefix_length))
+			{
+				insert(prefix, fields[1], score);
+			}
+			g_free(prefix);
+		}
+		g_strfreev(fields);
+	}
+	g_strfreev(lines);
+	g_free(contents);
+}
+
+//-----------------------------------------------------------------------------
+
+bool SearchHistory::prune_node(std::vector<Node>::size_type node, std::vector<Node>& nodes, std::vector<Node>::size_type pruned) const
+{
+	// Keep launchers that have not decayed away
+	for (std::vector<Entry>::const_iterator i = m_nodes[node].entries.begin(), end = m_nodes[node].entries.end(); i != end; ++i)
+	{
+		if (get_score(*i) >= min_score)
+		{
+			nodes[pruned].entries.push_back(*i);
+		}
+	}
+
+	// Keep children that still lead to launchers; an empty child has no
+	// children either, so it is always the last node added
+	for (std::map<unsigned char, std::vector<Node>::size_type>::const_iterator i = m_nodes[node].children.begin(), end = m_nodes[node].children.end(); i != end; ++i)
+	{
+		nodes.push_back(Node());
+		const std::vector<Node>::size_type child = nodes.size() - 1;
+		if (prune_node(i->second, nodes, child))
+		{
+			nodes[pruned].children[i->first] = child;
+		}
+		else
+		{
+			nodes.pop_back();
+		}
+	}
+
+	return !nodes[pruned].entries.empty() || !nodes[pruned].children.empty();
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchHistory::save()
+{
+	if (!m_file)
+	{
+		return;
+	}
+
+	// Remove forgotten launchers and the prefixes left without any
+	std::vector<Node> nodes;
+	nodes.push_back(Node());
+	prune_node(0, nodes, 0);
+	m_nodes.swap(nodes);
+
+	std::string prefix;
+	std::string contents;
+	save_node(0, prefix, contents);
+	m_writer.replace(m_file, contents);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchHistory::save_node(std::vector<Node>::size_type node, std::string& prefix, std::string& contents) const
+{
+	gchar* escaped = g_strescape(prefix.c_str(), NULL);
+	for (std::vector<Entry>::const_iterator i = m_nodes[node].entries.begin(), end = m_nodes[node].entries.end(); i != end; ++i)
+	{
+		// Store scores with the decay applied, which forgets unused launchers
+		float score = get_score(*i);
+		if (score < min_score)
+		{
+			continue;
+		}
+
+		gchar buffer[G_ASCII_DTOSTR_BUF_SIZE];
+		contents += escaped;
+		contents += '\t';
+		contents += i->desktop_id;
+		contents += '\t';
+		contents += g_ascii_dtostr(buffer, sizeof(buffer), score);
+		contents += '\n';
+	}
+	g_free(escaped);
+
+	for (std::map<unsigned char, std::vector<Node>::size_type>::const_iterator i = m_nodes[node].children.begin(), end = m_nodes[node].children.end(); i != end; ++i)
+	{
+		prefix += i->first;
+		save_node(i->second, prefix, contents);
+		prefix.erase(prefix.length() - 1);
+	}
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_SEARCH_HISTORY_H
+#define BLADEMENU_SEARCH_HISTORY_H
+
+#include "settings-writer.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+namespace BladeMenu
+{
+
+class SearchHistory
+{
+public:
+	SearchHistory();
+	~SearchHistory();
+
+	void add(const std::string& query, const gchar* desktop_id);
+	void find(const std::string& query, std::vector<std::string>& desktop_ids);
+
+private:
+	struct Entry
+	{
+		std::string desktop_id;
+		float score;
+		unsigned int time;
+	};
+
+	struct Node
+	{
+		std::map<unsigned char, std::vector<Node>::size_type> children;
+		std::vector<Entry> entries;
+	};
+
+	float get_score(const Entry& entry) const;
+	void insert(const std::string& prefix, const std::string& desktop_id, float score);
+	void load();
+	static gpointer load_thread(gpointer data);
+	void read();
+	bool prune_node(std::vector<Node>::size_type node, std::vector<Node>& nodes, std::vector<Node>::size_type pruned) const;
+	void save();
+	void save_node(std::vector<Node>::size_type node, std::string& prefix, std::string& contents) const;
+
+private:
+	std::vector<Node> m_nodes;
+	unsigned int m_time;
+	GThread* m_load_thread;
+	gchar* m_file;
+	SettingsWriter m_writer;
+};
+
+}
+
+#endif // BLADEMENU_SEARCH_HISTORY_H
@@ -19,12 +19,14 @@
 
 #include "launcher.h"
 #include "launcher-view.h"
+#include "memory-report.h"
 #include "search-action.h"
 #include "settings.h"
 #include "slot.h"
 #include "window.h"
 
 #include <algorithm>
+#include <functional>
 
 #include <gdk/gdkkeysyms.h>
 
@@ -32,10 +34,36 @@ using namespace BladeMenu;
 
 //-----------------------------------------------------------------------------
 
+// Number of earlier queries whose results are kept for backspacing
+static const unsigned int max_snapshots = 32;
+
+// Number of likely next characters whose results are found ahead of time
+static const unsigned int max_speculations = 3;
+
+// Most results kept for all speculative queries together
+static const unsigned int max_speculative_matches = 16384;
+
+// Time spent on speculative queries per idle call and per query, in usec
+static const gint64 speculation_time_slice = 2000;
+static const gint64 max_speculation_time = 40000;
+
+//-----------------------------------------------------------------------------
+
 SearchPage::SearchPage(Window* window) :
-	Page(window)
+	Page(window),
+	m_snapshots(max_snapshots),
+	m_snapshot_count(0),
+	m_speculations(max_speculations),
+	m_speculation_count(0),
+	m_speculation_limit(0),
+	m_speculation_position(0),
+	m_speculation_time(0),
+	m_speculate_idle_id(0)
 {
+	m_speculative_query.set_speculative(true);
+
 	get_view()->set_selection_mode(GTK_SELECTION_BROWSE);
+	get_view()->set_text_func((GtkTreeCellDataFunc)&SearchPage::highlight_text, this);
 
 	g_signal_connect_slot(window->get_search_entry(), "icon-release", &SearchPage::clear_search, this);
 	g_signal_connect_slot(window->get_search_entry(), "key-press-event", &SearchPage::cancel_search, this);
@@ -56,8 +84,12 @@ void SearchPage::set_filter(const gchar* filter)
 	// Clear search results for empty filter
 	if (!filter)
 	{
+		stop_speculation();
 		m_query.clear();
 		m_matches.clear();
+		m_search_action_matches.clear();
+		m_search_actions.clear();
+		m_snapshot_count = 0;
 		return;
 	}
 
@@ -68,9 +100,31 @@ void SearchPage::set_filter(const gchar* filter)
 		return;
 	}
 
-	// Reset search results if new search does not start with previous search
-	if (m_query.raw_query().empty() || !g_str_has_prefix(filter, m_query.raw_query().c_str()))
+	// Use results found ahead of time if this keystroke was predicted; they
+	// narrow the current results, so they go on top of the snapshots
+	for (std::vector<Snapshot>::size_type i = 0; i < m_speculation_count; ++i)
+	{
+		if (m_speculations[i].query == query)
+		{
+			push_snapshot().swap(m_speculations[i]);
+			break;
+		}
+	}
+	stop_speculation();
+
+	// Forget results of queries that this search does not start with, so
+	// that deleting or editing characters falls back to the longest prefix
+	while (m_snapshot_count && !g_str_has_prefix(filter, m_snapshots[m_snapshot_count - 1].query.c_str()))
+	{
+		--m_snapshot_count;
+	}
+
+	// Reset search results if there are no results to narrow down
+	bool restored = false;
+	if (!m_snapshot_count)
 	{
+		m_search_actions.set_actions(wm_settings->search_actions);
+
 		m_matches.clear();
 		m_matches.push_back(&m_run_action);
 		for (std::vector<Launcher*>::size_type i = 0, end = m_launchers.size(); i < end; ++i)
@@ -78,33 +132,59 @@ void SearchPage::set_filter(const gchar* filter)
 			m_matches.push_back(m_launchers[i]);
 		}
 	}
-	else if (std::find(m_matches.begin(), m_matches.end(), &m_run_action) == m_matches.end())
+	else
 	{
-		m_matches.insert(m_matches.begin(), &m_run_action);
+		const Snapshot& snapshot = m_snapshots[m_snapshot_count - 1];
+		m_matches = snapshot.matches;
+		restored = snapshot.query == query;
+		if (!restored && (std::find(m_matches.begin(), m_matches.end(), &m_run_action) == m_matches.end()))
+		{
+			m_matches.insert(m_matches.begin(), &m_run_action);
+		}
 	}
 	m_query.set(query);
 
 	// Create search results
-	std::vector<Match> search_action_matches;
-	search_action_matches.reserve(wm_settings->search_actions.size());
-	for (std::vector<SearchAction*>::size_type i = 0, end = wm_settings->search_actions.size(); i < end; ++i)
+	m_search_actions.find(query, m_search_action_candidates);
+	m_search_action_matches.clear();
+	for (std::vector<SearchAction*>::size_type i = 0, end = m_search_action_candidates.size(); i < end; ++i)
 	{
-		Match match(wm_settings->search_actions[i]);
+		Match match(m_search_action_candidates[i]);
 		match.update(m_query);
 		if (!Match::invalid(match))
 		{
-			search_action_matches.push_back(match);
+			m_search_action_matches.push_back(match);
 		}
 	}
-	std::stable_sort(search_action_matches.begin(), search_action_matches.end());
-	std::reverse(search_action_matches.begin(), search_action_matches.end());
+	std::stable_sort(m_search_action_matches.begin(), m_search_action_matches.end());
+	std::reverse(m_search_action_matches.begin(), m_search_action_matches.end());
 
-	for (std::vector<Match>::size_type i = 0, end = m_matches.size(); i < end; ++i)
+	if (restored)
 	{
-		m_matches[i].update(m_query);
+		restore_run_action();
+		m_predictions = m_snapshots[m_snapshot_count - 1].predictions;
+	}
+	else
+	{
+		for (std::vector<Match>::size_type i = 0, end = m_matches.size(); i < end; ++i)
+		{
+			m_matches[i].update(m_query);
+		}
+		m_matches.erase(std::remove_if(m_matches.begin(), m_matches.end(), &Match::invalid), m_matches.end());
+		std::stable_sort(m_matches.begin(), m_matches.end());
+		boost_matches(m_query, m_matches);
+
+		for (std::vector<Match>::size_type i = 0, end = m_matches.size(); i < end; ++i)
+		{
+			count_next_character(m_matches[i].element(), m_query);
+		}
+		predict(m_predictions);
+
+		Snapshot& snapshot = push_snapshot();
+		snapshot.query = query;
+		snapshot.matches = m_matches;
+		snapshot.predictions = m_predictions;
 	}
-	m_matches.erase(std::remove_if(m_matches.begin(), m_matches.end(), &Match::invalid), m_matches.end());
-	std::stable_sort(m_matches.begin(), m_matches.end());
 
 	// Show search results
 	GtkListStore* store = gtk_list_store_new(
@@ -114,9 +194,9 @@ void SearchPage::set_filter(const gchar* filter)
 			G_TYPE_STRING,
 			G_TYPE_POINTER);
 	Element* element;
-	for (std::vector<Match>::size_type i = 0, end = search_action_matches.size(); i < end; ++i)
+	for (std::vector<Match>::size_type i = 0, end = m_search_action_matches.size(); i < end; ++i)
 	{
-		element = search_action_matches[i].element();
+		element = m_search_action_matches[i].element();
 		gtk_list_store_insert_with_values(
 				store, NULL, G_MAXINT,
 				LauncherView::COLUMN_ICON, element->get_icon(),
@@ -151,6 +231,8 @@ void SearchPage::set_filter(const gchar* filter)
 		get_view()->scroll_to_path(path);
 	}
 	gtk_tree_path_free(path);
+
+	start_speculation();
 }
 
 //-----------------------------------------------------------------------------
@@ -175,19 +257,295 @@ void SearchPage::set_menu_items(GtkTreeModel* model)
 
 	m_matches.clear();
 	m_matches.reserve(m_launchers.size() + 1);
+	m_snapshot_count = 0;
+	stop_speculation();
 }
 
 //-----------------------------------------------------------------------------
 
 void SearchPage::unset_menu_items()
 {
+	stop_speculation();
 	m_launchers.clear();
 	m_matches.clear();
+	m_snapshot_count = 0;
 	get_view()->unset_model();
 }
 
 //-----------------------------------------------------------------------------
 
+void SearchPage::measure(MemoryReport& report) const
+{
+	report.add_vector(MemoryReport::SearchIndex, m_launchers);
+	report.add_vector(MemoryReport::SearchIndex, m_search_action_candidates);
+	report.add_vector(MemoryReport::SearchIndex, m_matches);
+	report.add_vector(MemoryReport::SearchIndex, m_search_action_matches);
+	report.add_vector(MemoryReport::SearchIndex, m_snapshots);
+	for (std::vector<Snapshot>::const_iterator i = m_snapshots.begin(), end = m_snapshots.end(); i != end; ++i)
+	{
+		report.add_string(MemoryReport::SearchIndex, i->query);
+		report.add_vector(MemoryReport::SearchIndex, i->matches);
+		report.add_vector(MemoryReport::SearchIndex, i->predictions);
+	}
+	report.add_vector(MemoryReport::SearchIndex, m_speculations);
+	for (std::vector<Snapshot>::const_iterator i = m_speculations.begin(), end = m_speculations.end(); i != end; ++i)
+	{
+		report.add_string(MemoryReport::SearchIndex, i->query);
+		report.add_vector(MemoryReport::SearchIndex, i->matches);
+		report.add_vector(MemoryReport::SearchIndex, i->predictions);
+	}
+	report.add_vector(MemoryReport::SearchIndex, m_predictions);
+	report.add_map(MemoryReport::SearchIndex, m_next_characters);
+	report.add_model(MemoryReport::Models, get_view()->get_model());
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::launcher_activated(Launcher* launcher)
+{
+	m_history.add(m_query.query(), launcher->get_desktop_id());
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::boost_matches(const Query& query, std::vector<Match>& matches)
+{
+	// Move launchers that were often activated for this query to the top,
+	// in order of how often
+	m_history.find(query.query(), m_boosted);
+	std::vector<Match>::iterator first = matches.begin();
+	for (std::vector<std::string>::const_iterator i = m_boosted.begin(), end = m_boosted.end(); i != end; ++i)
+	{
+		for (std::vector<Match>::iterator match = first, matches_end = matches.end(); match != matches_end; ++match)
+		{
+			Element* element = match->element();
+			if ((element->get_type() == Launcher::Type) && (*i == static_cast<Launcher*>(element)->get_desktop_id()))
+			{
+				std::rotate(first, match, match + 1);
+				++first;
+				break;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+SearchPage::Snapshot& SearchPage::push_snapshot()
+{
+	// Drop the shortest query when full, which is the least likely to be
+	// returned to; swapping moves the vectors without copying them
+	if (m_snapshot_count == m_snapshots.size())
+	{
+		for (std::vector<Snapshot>::size_type i = 1; i < m_snapshot_count; ++i)
+		{
+			m_snapshots[i - 1].swap(m_snapshots[i]);
+		}
+		--m_snapshot_count;
+	}
+
+	// Assigning to the returned snapshot reuses the memory of snapshots that
+	// were forgotten earlier
+	++m_snapshot_count;
+	return m_snapshots[m_snapshot_count - 1];
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::restore_run_action()
+{
+	// Text of the run action depends on the query, so refresh only it
+	std::vector<Match>::iterator i = std::find(m_matches.begin(), m_matches.end(), &m_run_action);
+	if (i != m_matches.end())
+	{
+		i->update(m_query);
+		if (Match::invalid(*i))
+		{
+			m_matches.erase(i);
+		}
+		return;
+	}
+
+	// Speculative results leave out the run action, because searching
+	// changes its text; insert it after the results that sort before it
+	Match match(&m_run_action);
+	match.update(m_query);
+	if (Match::invalid(match))
+	{
+		return;
+	}
+	for (i = m_matches.begin(); i != m_matches.end(); ++i)
+	{
+		if (match < *i)
+		{
+			break;
+		}
+	}
+	m_matches.insert(i, match);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::count_next_character(Element* element, const Query& query)
+{
+	if (element->get_type() != Launcher::Type)
+	{
+		return;
+	}
+
+	gunichar c = static_cast<Launcher*>(element)->get_next_character(query);
+	if (c && !g_unichar_isspace(c))
+	{
+		++m_next_characters[c];
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::predict(std::vector<gunichar>& predictions)
+{
+	// Predict the characters that most often follow the query in the names
+	// of the results
+	std::vector<std::pair<unsigned int, gunichar> > counts;
+	for (std::map<gunichar, unsigned int>::const_iterator i = m_next_characters.begin(), end = m_next_characters.end(); i != end; ++i)
+	{
+		counts.push_back(std::make_pair(i->second, i->first));
+	}
+	m_next_characters.clear();
+
+	std::vector<std::pair<unsigned int, gunichar> >::size_type count = std::min(counts.size(), std::vector<std::pair<unsigned int, gunichar> >::size_type(max_speculations));
+	std::partial_sort(counts.begin(), counts.begin() + count, counts.end(), std::greater<std::pair<unsigned int, gunichar> >());
+
+	predictions.clear();
+	for (std::vector<std::pair<unsigned int, gunichar> >::size_type i = 0; i < count; ++i)
+	{
+		predictions.push_back(counts[i].second);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::start_speculation()
+{
+	stop_speculation();
+
+	// Limit how many results are kept; each speculative query has at most
+	// as many results as the current query
+	const std::vector<Match>::size_type results = std::max(m_matches.size(), std::vector<Match>::size_type(1));
+	m_speculation_limit = std::min(m_predictions.size(), max_speculative_matches / results);
+	if (!m_speculation_limit)
+	{
+		return;
+	}
+
+	// Run after pending input and redraws have been handled
+	m_speculate_idle_id = g_idle_add_full(G_PRIORITY_LOW, (GSourceFunc)&SearchPage::speculate_idle, this, NULL);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::stop_speculation()
+{
+	if (m_speculate_idle_id)
+	{
+		g_source_remove(m_speculate_idle_id);
+		m_speculate_idle_id = 0;
+	}
+	m_speculation_count = 0;
+	m_speculation_limit = 0;
+	m_speculation_position = 0;
+	m_speculation_time = 0;
+	m_next_characters.clear();
+}
+
+//-----------------------------------------------------------------------------
+
+bool SearchPage::speculate()
+{
+	const gint64 start = g_get_monotonic_time();
+	const gint64 end = start + speculation_time_slice;
+
+	while (m_speculation_count < m_speculation_limit)
+	{
+		Snapshot& speculation = m_speculations[m_speculation_count];
+		if (!m_speculation_position)
+		{
+			gchar c[6];
+			speculation.query = m_query.raw_query();
+			speculation.query.append(c, g_unichar_to_utf8(m_predictions[m_speculation_count], c));
+			speculation.matches.clear();
+			m_speculative_query.set(speculation.query);
+		}
+
+		// Narrow down the current results, checking the time only every few
+		// results because it costs more than a match
+		for (std::vector<Match>::size_type size = m_matches.size(); m_speculation_position < size; ++m_speculation_position)
+		{
+			if (!(m_speculation_position & 0x3F) && (g_get_monotonic_time() >= end))
+			{
+				m_speculation_time += g_get_monotonic_time() - start;
+				return m_speculation_time < max_speculation_time;
+			}
+
+			Match match = m_matches[m_speculation_position];
+			if (match.element() == &m_run_action)
+			{
+				continue;
+			}
+			match.update(m_speculative_query);
+			if (!Match::invalid(match))
+			{
+				speculation.matches.push_back(match);
+				count_next_character(match.element(), m_speculative_query);
+			}
+		}
+
+		std::stable_sort(speculation.matches.begin(), speculation.matches.end());
+		boost_matches(m_speculative_query, speculation.matches);
+		predict(speculation.predictions);
+
+		++m_speculation_count;
+		m_speculation_position = 0;
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
+gboolean SearchPage::speculate_idle(SearchPage* page)
+{
+	if (page->speculate())
+	{
+		return true;
+	}
+
+	page->m_speculate_idle_id = 0;
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::highlight_text(GtkTreeViewColumn*, GtkCellRenderer* renderer, GtkTreeModel* model, GtkTreeIter* iter, SearchPage* page)
+{
+	gchar* text = NULL;
+	Element* element = NULL;
+	gtk_tree_model_get(model, iter, LauncherView::COLUMN_TEXT, &text, LauncherView::COLUMN_LAUNCHER, &element, -1);
+
+	// Highlight matches only in rows that are shown
+	gchar* highlighted = NULL;
+	if (element && (element->get_type() == Launcher::Type))
+	{
+		highlighted = static_cast<Launcher*>(element)->create_highlighted_text(page->m_query);
+	}
+	g_object_set(renderer, "markup", highlighted ? highlighted : text, NULL);
+
+	g_free(highlighted);
+	g_free(text);
+}
+
+//-----------------------------------------------------------------------------
+
 void SearchPage::activate_search()
 {
 	GtkTreePath* path = get_view()->get_selected_path();
@@ -21,13 +21,18 @@
 #include "page.h"
 #include "query.h"
 #include "run-action.h"
+#include "search-action-dispatcher.h"
+#include "search-history.h"
 
+#include <map>
 #include <string>
 #include <vector>
 
 namespace BladeMenu
 {
 
+class MemoryReport;
+
 class SearchPage : public Page
 {
 public:
@@ -37,8 +42,23 @@ public:
 	void set_filter(const gchar* filter);
 	void set_menu_items(GtkTreeModel* model);
 	void unset_menu_items();
+	void measure(MemoryReport& report) const;
 
 private:
+	class Match;
+	class Snapshot;
+
+	void launcher_activated(Launcher* launcher);
+	void boost_matches(const Query& query, std::vector<Match>& matches);
+	Snapshot& push_snapshot();
+	void restore_run_action();
+	void count_next_character(Element* element, const Query& query);
+	void predict(std::vector<gunichar>& predictions);
+	void start_speculation();
+	void stop_speculation();
+	bool speculate();
+	static gboolean speculate_idle(SearchPage* page);
+	static void highlight_text(GtkTreeViewColumn*, GtkCellRenderer* renderer, GtkTreeModel* model, GtkTreeIter* iter, SearchPage* page);
 	void activate_search();
 	void clear_search(GtkEntry* entry, GtkEntryIconPosition icon_pos, GdkEvent*);
 	gboolean cancel_search(GtkWidget* widget, GdkEvent* event);
@@ -47,6 +67,10 @@ private:
 	Query m_query;
 	std::vector<Launcher*> m_launchers;
 	RunAction m_run_action;
+	SearchActionDispatcher m_search_actions;
+	std::vector<SearchAction*> m_search_action_candidates;
+	SearchHistory m_history;
+	std::vector<std::string> m_boosted;
 
 	class Match
 	{
@@ -88,6 +112,34 @@ private:
 		guint m_relevancy;
 	};
 	std::vector<Match> m_matches;
+	std::vector<Match> m_search_action_matches;
+
+	class Snapshot
+	{
+	public:
+		void swap(Snapshot& snapshot)
+		{
+			query.swap(snapshot.query);
+			matches.swap(snapshot.matches);
+			predictions.swap(snapshot.predictions);
+		}
+
+		std::string query;
+		std::vector<Match> matches;
+		std::vector<gunichar> predictions;
+	};
+	std::vector<Snapshot> m_snapshots;
+	std::vector<Snapshot>::size_type m_snapshot_count;
+
+	std::vector<gunichar> m_predictions;
+	std::map<gunichar, unsigned int> m_next_characters;
+	Query m_speculative_query;
+	std::vector<Snapshot> m_speculations;
+	std::vector<Snapshot>::size_type m_speculation_count;
+	std::vector<Snapshot>::size_type m_speculation_limit;
+	std::vector<Match>::size_type m_speculation_position;
+	gint64 m_speculation_time;
+	guint m_speculate_idle_id;
 };
 
 }
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "search-text.h"
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+static inline guint64 signature_bit(gunichar c)
+{
+	return G_GUINT64_CONSTANT(1) << (guint32(c * 2654435761U) >> 26);
+}
+
+//-----------------------------------------------------------------------------
+
+guint64 SearchText::signature(const std::string& text)
+{
+	// Set one of 64 bits for every character except whitespace, which is
+	// not required to be present by any of the query matches
+	guint64 result = 0;
+	for (const gchar* pos = text.c_str(); *pos; pos = g_utf8_next_char(pos))
+	{
+		gunichar c = g_utf8_get_char(pos);
+		if (!g_unichar_isspace(c))
+		{
+			result |= signature_bit(c);
+		}
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchText::index()
+{
+	// Find the offsets of words in the same pass as the signature, so that
+	// matching queries does not need to decode the text again; offsets past
+	// the range of guint16 are not stored, which no menu text reaches
+	m_word_starts.clear();
+	m_signature = 0;
+
+	bool start_word = true;
+	const gchar* text = m_text.c_str();
+	for (const gchar* pos = text; *pos; pos = g_utf8_next_char(pos))
+	{
+		if (start_word && (pos - text <= G_MAXUINT16))
+		{
+			m_word_starts.push_back(pos - text);
+		}
+
+		gunichar c = g_utf8_get_char(pos);
+		start_word = g_unichar_isspace(c);
+		if (!start_word)
+		{
+			m_signature |= signature_bit(c);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_SEARCH_TEXT_H
+#define BLADEMENU_SEARCH_TEXT_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+namespace BladeMenu
+{
+
+class SearchText
+{
+public:
+	struct Span
+	{
+		std::string::size_type start;
+		std::string::size_type end;
+	};
+
+	SearchText() :
+		m_signature(0)
+	{
+	}
+
+	SearchText& operator=(const std::string& text)
+	{
+		m_text = text;
+		index();
+		return *this;
+	}
+
+	void clear()
+	{
+		m_text.clear();
+		m_word_starts.clear();
+		m_signature = 0;
+	}
+
+	bool empty() const
+	{
+		return m_text.empty();
+	}
+
+	const std::string& str() const
+	{
+		return m_text;
+	}
+
+	guint64 get_signature() const
+	{
+		return m_signature;
+	}
+
+	gsize get_size() const
+	{
+		return m_text.capacity() + 1 + (m_word_starts.capacity() * sizeof(guint16));
+	}
+
+	const std::vector<guint16>& get_word_starts() const
+	{
+		return m_word_starts;
+	}
+
+	bool is_word_start(std::string::size_type pos) const
+	{
+		return std::binary_search(m_word_starts.begin(), m_word_starts.end(), pos);
+	}
+
+	bool may_contain(guint64 signature) const
+	{
+		return (signature & ~m_signature) == 0;
+	}
+
+	static guint64 signature(const std::string& text);
+
+private:
+	void index();
+
+private:
+	std::string m_text;
+	std::vector<guint16> m_word_starts;
+	guint64 m_signature;
+};
+
+}
+
+#endif // BLADEMENU_SEARCH_TEXT_H
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "settings-writer.h"
+
+#include <cstdio>
+
+#include <glib/gstdio.h>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+SettingsWriter::SettingsWriter() :
+	m_thread(NULL),
+	m_busy(false),
+	m_quit(false)
+{
+	g_mutex_init(&m_mutex);
+	g_cond_init(&m_cond);
+}
+
+//-----------------------------------------------------------------------------
+
+SettingsWriter::~SettingsWriter()
+{
+	// Write everything that is still queued before exiting
+	if (m_thread)
+	{
+		g_mutex_lock(&m_mutex);
+		m_quit = true;
+		g_cond_broadcast(&m_cond);
+		g_mutex_unlock(&m_mutex);
+
+		g_thread_join(m_thread);
+	}
+
+	g_cond_clear(&m_cond);
+	g_mutex_clear(&m_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
+void SettingsWriter::append(const std::string& file, const std::string& contents, Callback callback, gpointer data)
+{
+	queue(file, contents, true, callback, data);
+}
+
+//-----------------------------------------------------------------------------
+
+void SettingsWriter::replace(const std::string& file, const std::string& contents, Callback callback, gpointer data)
+{
+	queue(file, contents, false, callback, data);
+}
+
+//-----------------------------------------------------------------------------
+
+void SettingsWriter::flush()
+{
+	g_mutex_lock(&m_mutex);
+	while (!m_jobs.empty() || m_busy)
+	{
+		g_cond_wait(&m_cond, &m_mutex);
+	}
+	g_mutex_unlock(&m_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
+void SettingsWriter::queue(const std::string& file, const std::string& contents, bool append, Callback callback, gpointer data)
+{
+	g_mutex_lock(&m_mutex);
+
+	// Merge with the last pending job for the same file; a replacement
+	// supersedes anything queued before it
+	if (!m_jobs.empty() && (m_jobs.back().file == file))
+	{
+		Job& job = m_jobs.back();
+		if (!append)
+		{
+			job.contents = contents;
+			job.append = false;
+		}
+		else
+		{
+			job.contents += contents;
+		}
+	}
+	else
+	{
+		Job job;
+		job.file = file;
+		job.contents = contents;
+		job.append = append;
+		m_jobs.push_back(job);
+	}
+
+	// Merged jobs report to every caller, in the order they were queued
+	if (callback)
+	{
+		m_jobs.back().callbacks.push_back(std::make_pair(callback, data));
+	}
+
+	if (!m_thread)
+	{
+		m_thread = g_thread_new("blademenu-settings", &SettingsWriter::run_thread, this);
+	}
+	g_cond_broadcast(&m_cond);
+
+	g_mutex_unlock(&m_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
+void SettingsWriter::run()
+{
+	g_mutex_lock(&m_mutex);
+	for (;;)
+	{
+		if (m_jobs.empty())
+		{
+			m_busy = false;
+			g_cond_broadcast(&m_cond);
+			if (m_quit)
+			{
+				break;
+			}
+			g_cond_wait(&m_cond, &m_mutex);
+			continue;
+		}
+
+		Job job = m_jobs.front();
+		m_jobs.pop_front();
+		m_busy = true;
+		g_mutex_unlock(&m_mutex);
+
+		bool written = false;
+		if (job.append)
+		{
+			// Close on exec, so that spawned applications do not inherit it
+			FILE* stream = g_fopen(job.file.c_str(), "a+e");
+			if (stream)
+			{
+				// End a line left by an interrupted write, so that it is not
+				// joined with the first appended line
+				written = true;
+				if ((fseek(stream, -1, SEEK_END) == 0) && (fgetc(stream) != '\n'))
+				{
+					written = (fseek(stream, 0, SEEK_END) == 0) && (fputc('\n', stream) != EOF);
+				}
+				written = written && (fwrite(job.contents.c_str(), 1, job.contents.length(), stream) == job.contents.length());
+				written = (fclose(stream) == 0) && written;
+			}
+		}
+		else
+		{
+			written = g_file_set_contents(job.file.c_str(), job.contents.c_str(), job.contents.length(), NULL);
+		}
+
+		if (!written)
+		{
+			g_warning("Unable to save settings: %s", job.file.c_str());
+		}
+
+		for (std::vector<std::pair<Callback, gpointer> >::const_iterator i = job.callbacks.begin(), end = job.callbacks.end(); i != end; ++i)
+		{
+			i->first(written, i->second);
+		}
+
+		g_mutex_lock(&m_mutex);
+	}
+	g_mutex_unlock(&m_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
+gpointer SettingsWriter::run_thread(gpointer data)
+{
+	static_cast<SettingsWriter*>(data)->run();
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_SETTINGS_WRITER_H
+#define BLADEMENU_SETTINGS_WRITER_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+namespace BladeMenu
+{
+
+class SettingsWriter
+{
+public:
+	SettingsWriter();
+	~SettingsWriter();
+
+	// Called in the writer thread after the contents were written or failed
+	typedef void (*Callback)(bool written, gpointer data);
+
+	void append(const std::string& file, const std::string& contents, Callback callback = NULL, gpointer data = NULL);
+	void replace(const std::string& file, const std::string& contents, Callback callback = NULL, gpointer data = NULL);
+	void flush();
+
+private:
+	void queue(const std::string& file, const std::string& contents, bool append, Callback callback, gpointer data);
+	void run();
+	static gpointer run_thread(gpointer data);
+
+private:
+	struct Job
+	{
+		std::string file;
+		std::string contents;
+		bool append;
+		std::vector<std::pair<Callback, gpointer> > callbacks;
+	};
+	std::deque<Job> m_jobs;
+
+	GThread* m_thread;
+	GMutex m_mutex;
+	GCond m_cond;
+	bool m_busy;
+	bool m_quit;
+};
+
+}
+
+#endif // BLADEMENU_SETTINGS_WRITER_H
@@ -19,12 +19,14 @@
 
 #include "command.h"
 #include "search-action.h"
+#include "settings-writer.h"
+#include "transliteration.h"
 
 #include <algorithm>
 
-#include <libbladeutil/libbladeutil.h>
+#include <cstring>
 
-#include <unistd.h>
+#include <glib/gstdio.h>
 
 using namespace BladeMenu;
 
@@ -32,6 +34,9 @@ using namespace BladeMenu;
 
 Settings* BladeMenu::wm_settings = NULL;
 
+// Number of entries in the journal before it is compacted
+static const unsigned int journal_lines_max = 32;
+
 static const char* const settings_command[Settings::CountCommands][2] = {
 	{ "command-settings",   "show-command-settings"   },
 	{ "command-lockscreen", "show-command-lockscreen" },
@@ -43,16 +48,10 @@ static const char* const settings_command[Settings::CountCommands][2] = {
 
 //-----------------------------------------------------------------------------
 
-static void read_vector_entry(XfceRc* rc, const char* key, std::vector<std::string>& desktop_ids)
+static void read_vector(gchar** values, std::vector<std::string>& desktop_ids)
 {
-	if (!xfce_rc_has_entry(rc, key))
-	{
-		return;
-	}
-
 	desktop_ids.clear();
 
-	gchar** values = xfce_rc_read_list_entry(rc, key, ",");
 	for (size_t i = 0; values[i] != NULL; ++i)
 	{
 		std::string desktop_id(values[i]);
@@ -61,27 +60,185 @@ static void read_vector_entry(XfceRc* rc, const char* key, std::vector<std::stri
 			desktop_ids.push_back(desktop_id);
 		}
 	}
+}
+
+//-----------------------------------------------------------------------------
+
+static void read_vector_entry(XfceRc* rc, const char* key, std::vector<std::string>& desktop_ids)
+{
+	if (!xfce_rc_has_entry(rc, key))
+	{
+		return;
+	}
+
+	gchar** values = xfce_rc_read_list_entry(rc, key, ",");
+	read_vector(values, desktop_ids);
 	g_strfreev(values);
 }
 
 //-----------------------------------------------------------------------------
 
-static void write_vector_entry(XfceRc* rc, const char* key, const std::vector<std::string>& desktop_ids)
+// Settings are serialized in the same format that XfceRc reads, so that the
+// file can be replaced atomically and compared against the previous save
+
+static void write_entry(std::string& contents, const char* key, const char* value)
 {
-	const std::vector<std::string>::size_type size = desktop_ids.size();
-	gchar** values = g_new0(gchar*, size + 1);
-	for (std::vector<std::string>::size_type i = 0; i < size; ++i)
+	contents += key;
+	contents += '=';
+
+	if (!value)
+	{
+		value = "";
+	}
+
+	// Escape leading whitespace, which XfceRc would otherwise strip
+	for (; (*value == ' ') || (*value == '\t'); ++value)
 	{
-		values[i] = g_strdup(desktop_ids[i].c_str());
+		contents += (*value == ' ') ? "\\ " : "\\t";
+	}
+
+	for (; *value; ++value)
+	{
+		switch (*value)
+		{
+		case '\\':
+			contents += "\\\\";
+			break;
+
+		case '\n':
+			contents += "\\n";
+			break;
+
+		case '\r':
+			contents += "\\r";
+			break;
+
+		case '\t':
+			contents += "\\t";
+			break;
+
+		default:
+			contents += *value;
+			break;
+		}
+	}
+
+	contents += '\n';
+}
+
+//-----------------------------------------------------------------------------
+
+static void write_bool_entry(std::string& contents, const char* key, bool value)
+{
+	write_entry(contents, key, value ? "true" : "false");
+}
+
+//-----------------------------------------------------------------------------
+
+static void write_int_entry(std::string& contents, const char* key, int value)
+{
+	gchar* string = g_strdup_printf("%d", value);
+	write_entry(contents, key, string);
+	g_free(string);
+}
+
+//-----------------------------------------------------------------------------
+
+static void write_vector_entry(std::string& contents, const char* key, const std::vector<std::string>& desktop_ids)
+{
+	std::string value;
+	for (std::vector<std::string>::const_iterator i = desktop_ids.begin(), end = desktop_ids.end(); i != end; ++i)
+	{
+		if (i != desktop_ids.begin())
+		{
+			value += ',';
+		}
+		value += *i;
+	}
+	write_entry(contents, key, value.c_str());
+}
+
+//-----------------------------------------------------------------------------
+
+static void write_group(std::string& contents, const char* group)
+{
+	contents += '\n';
+	contents += '[';
+	contents += group;
+	contents += "]\n";
+}
+
+//-----------------------------------------------------------------------------
+
+static gchar* journal_file(const gchar* file)
+{
+	return g_strconcat(file, ".journal", NULL);
+}
+
+//-----------------------------------------------------------------------------
+
+static bool is_journal_value(const gchar* value)
+{
+	// Lines joined by an interrupted write have a second key in the value,
+	// or a desktop id that was cut short
+	if (strchr(value, '='))
+	{
+		return false;
+	}
+
+	bool valid = true;
+	gchar** values = g_strsplit(value, ",", -1);
+	for (size_t i = 0; valid && (values[i] != NULL); ++i)
+	{
+		valid = (*values[i] == '\0') || g_str_has_suffix(values[i], ".desktop");
 	}
-	xfce_rc_write_list_entry(rc, key, values, ",");
 	g_strfreev(values);
+	return valid;
 }
 
 //-----------------------------------------------------------------------------
 
+// Files are opened and parsed on a worker thread, and the results are applied
+// to the settings from an idle callback in the main thread
+
+struct Settings::LoadRequest
+{
+	Settings* settings;
+	gchar* files[2];
+	XfceRc* rc[2];
+	gchar* save_file;
+	std::string contents;
+	gchar* journal;
+	GSourceFunc callback;
+	gpointer data;
+	GThread* thread;
+	guint source_id;
+};
+
+//-----------------------------------------------------------------------------
+
+// Lists written to the journal, which become the lists on disk once the
+// writer thread has written them
+
+struct Settings::JournalWrite
+{
+	Settings* settings;
+	std::vector<std::string> favorites;
+	std::vector<std::string> recent;
+	unsigned int lines;
+	bool compact;
+};
+
+//-----------------------------------------------------------------------------
+
 Settings::Settings() :
+	m_load_request(NULL),
+	m_writer(new SettingsWriter),
+	m_loaded(false),
 	m_modified(false),
+	m_removed(false),
+	m_journal_lines(0),
+	m_journal_exists(false),
 
 	button_icon_name("blade-menu"),
 	button_title_visible(false),
@@ -91,6 +248,7 @@ Settings::Settings() :
 	launcher_show_name(true),
 	launcher_show_description(true),
 	launcher_show_tooltip(true),
+	launcher_prefetch(false),
 	launcher_icon_size(IconSize::Small),
 
 	category_hover_activate(false),
@@ -98,6 +256,8 @@ Settings::Settings() :
 	category_icon_size(IconSize::Smaller),
 
 	load_hierarchy(false),
+	load_background(true),
+	search_transliterate(Transliteration::is_preferred()),
 
 	recent_items_max(10),
 	favorites_in_recent(true),
@@ -128,12 +288,26 @@ Settings::Settings() :
 	search_actions.push_back(new SearchAction(_("Wikipedia"), "!w", "blxo-open --launch WebBrowser https://en.wikipedia.org/wiki/%u", false, true));
 	search_actions.push_back(new SearchAction(_("Run in Terminal"), "!", "blxo-open --launch TerminalEmulator %s", false, true));
 	search_actions.push_back(new SearchAction(_("Open URI"), "^(file|http|https):\\/\\/(.*)$", "blxo-open \\0", true, true));
+
+	g_mutex_init(&m_journal_mutex);
 }
 
 //-----------------------------------------------------------------------------
 
 Settings::~Settings()
 {
+	if (m_load_request)
+	{
+		g_thread_join(m_load_request->thread);
+		g_source_remove(m_load_request->source_id);
+		free_load_request(m_load_request);
+		m_load_request = NULL;
+	}
+
+	// Wait for pending saves to finish
+	delete m_writer;
+	g_mutex_clear(&m_journal_mutex);
+
 	for (int i = 0; i < CountCommands; ++i)
 	{
 		delete command[i];
@@ -147,19 +321,114 @@ Settings::~Settings()
 
 //-----------------------------------------------------------------------------
 
-void Settings::load(char* file)
+void Settings::load_async(gchar* defaults_file, gchar* file, gchar* save_file, GSourceFunc callback, gpointer data)
 {
-	if (!file)
+	g_assert(!m_load_request && !m_loaded);
+
+	LoadRequest* request = new LoadRequest;
+	request->settings = this;
+	request->files[0] = defaults_file;
+	request->files[1] = file;
+	request->rc[0] = NULL;
+	request->rc[1] = NULL;
+	request->save_file = save_file;
+	request->journal = NULL;
+	request->callback = callback;
+	request->data = data;
+	request->source_id = 0;
+	m_load_request = request;
+
+	request->thread = g_thread_new("blademenu-load", &Settings::load_thread, request);
+}
+
+//-----------------------------------------------------------------------------
+
+gpointer Settings::load_thread(gpointer data)
+{
+	LoadRequest* request = static_cast<LoadRequest*>(data);
+
+	for (int i = 0; i < 2; ++i)
 	{
-		return;
+		if (request->files[i])
+		{
+			request->rc[i] = xfce_rc_simple_open(request->files[i], true);
+		}
 	}
 
-	XfceRc* rc = xfce_rc_simple_open(file, true);
-	g_free(file);
-	if (!rc)
+	if (request->save_file)
 	{
-		return;
+		gchar* contents = NULL;
+		gsize length = 0;
+		if (g_file_get_contents(request->save_file, &contents, &length, NULL))
+		{
+			request->contents.assign(contents, length);
+			g_free(contents);
+		}
+
+		gchar* journal = journal_file(request->save_file);
+		g_file_get_contents(journal, &request->journal, NULL, NULL);
+		g_free(journal);
+	}
+
+	request->source_id = g_idle_add(&Settings::load_finished, request);
+
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+gboolean Settings::load_finished(gpointer data)
+{
+	LoadRequest* request = static_cast<LoadRequest*>(data);
+	g_thread_join(request->thread);
+
+	// Apply defaults, then user settings, then journaled lists
+	Settings* settings = request->settings;
+	for (int i = 0; i < 2; ++i)
+	{
+		if (request->rc[i])
+		{
+			settings->load(request->rc[i]);
+		}
 	}
+	if (request->journal)
+	{
+		settings->load_journal(request->journal);
+	}
+	settings->m_contents = request->contents;
+	settings->m_loaded = true;
+	settings->m_load_request = NULL;
+
+	GSourceFunc callback = request->callback;
+	gpointer callback_data = request->data;
+	free_load_request(request);
+
+	callback(callback_data);
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
+void Settings::free_load_request(LoadRequest* request)
+{
+	for (int i = 0; i < 2; ++i)
+	{
+		if (request->rc[i])
+		{
+			xfce_rc_close(request->rc[i]);
+		}
+		g_free(request->files[i]);
+	}
+	g_free(request->save_file);
+	g_free(request->journal);
+	delete request;
+}
+
+//-----------------------------------------------------------------------------
+
+void Settings::load(XfceRc* rc)
+{
 	xfce_rc_set_group(rc, NULL);
 
 	read_vector_entry(rc, "favorites", favorites);
@@ -176,6 +445,7 @@ void Settings::load(char* file)
 	launcher_show_name = xfce_rc_read_bool_entry(rc, "launcher-show-name", launcher_show_name);
 	launcher_show_description = xfce_rc_read_bool_entry(rc, "launcher-show-description", launcher_show_description);
 	launcher_show_tooltip = xfce_rc_read_bool_entry(rc, "launcher-show-tooltip", launcher_show_tooltip);
+	launcher_prefetch = xfce_rc_read_bool_entry(rc, "launcher-prefetch", launcher_prefetch);
 	launcher_icon_size = xfce_rc_read_int_entry(rc, "item-icon-size", launcher_icon_size);
 
 	category_hover_activate = xfce_rc_read_bool_entry(rc, "hover-switch-category", category_hover_activate);
@@ -183,6 +453,8 @@ void Settings::load(char* file)
 	category_show_name = xfce_rc_read_bool_entry(rc, "category-show-name", category_show_name) || (category_icon_size == -1);
 
 	load_hierarchy = xfce_rc_read_bool_entry(rc, "load-hierarchy", load_hierarchy);
+	load_background = xfce_rc_read_bool_entry(rc, "load-background", load_background);
+	search_transliterate = xfce_rc_read_bool_entry(rc, "search-transliterate", search_transliterate);
 
 	recent_items_max = std::max(0, xfce_rc_read_int_entry(rc, "recent-items-max", recent_items_max));
 	favorites_in_recent = xfce_rc_read_bool_entry(rc, "favorites-in-recent", favorites_in_recent);
@@ -232,13 +504,62 @@ void Settings::load(char* file)
 		}
 	}
 
-	xfce_rc_close(rc);
-
 	m_modified = false;
 }
 
 //-----------------------------------------------------------------------------
 
+void Settings::load_journal(const gchar* contents)
+{
+	// Later lines replace earlier ones; the text after the last newline is
+	// either empty or an interrupted write, so it is ignored
+	gchar** lines = g_strsplit(contents, "\n", -1);
+	for (guint i = 0, count = g_strv_length(lines); (i + 1) < count; ++i)
+	{
+		gchar* value = strchr(lines[i], '=');
+		if (!value)
+		{
+			continue;
+		}
+		*value = '\0';
+		++value;
+
+		std::vector<std::string>* desktop_ids = NULL;
+		if (strcmp(lines[i], "favorites") == 0)
+		{
+			desktop_ids = &favorites;
+		}
+		else if (strcmp(lines[i], "recent") == 0)
+		{
+			desktop_ids = &recent;
+		}
+		else
+		{
+			continue;
+		}
+
+		if (!is_journal_value(value))
+		{
+			continue;
+		}
+
+		gchar** values = g_strsplit(value, ",", -1);
+		read_vector(values, *desktop_ids);
+		g_strfreev(values);
+
+		++m_journal_lines;
+	}
+	g_strfreev(lines);
+
+	g_mutex_lock(&m_journal_mutex);
+	m_journal_favorites = favorites;
+	m_journal_recent = recent;
+	m_journal_exists = true;
+	g_mutex_unlock(&m_journal_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
 void Settings::save(char* file)
 {
 	if (!file)
@@ -246,78 +567,177 @@ void Settings::save(char* file)
 		return;
 	}
 
-	// Start with fresh settings
-	unlink(file);
-
-	XfceRc* rc = xfce_rc_simple_open(file, false);
-	g_free(file);
-	if (!rc)
+	// Never replace the user's settings with defaults, and never recreate
+	// them after the plugin was removed
+	if (!m_loaded || m_removed)
 	{
+		g_free(file);
 		return;
 	}
-	xfce_rc_set_group(rc, NULL);
 
-	write_vector_entry(rc, "favorites", favorites);
-	write_vector_entry(rc, "recent", recent);
+	// Favorites and recent change almost every time the menu is used, so
+	// they are appended to a journal instead of rewriting all settings
+	save_journal(file);
+
+	std::string contents;
 
 	if (!custom_menu_file.empty())
 	{
-		xfce_rc_write_entry(rc, "custom-menu-file", custom_menu_file.c_str());
+		write_entry(contents, "custom-menu-file", custom_menu_file.c_str());
 	}
 
-	xfce_rc_write_entry(rc, "button-title", button_title.c_str());
-	xfce_rc_write_entry(rc, "button-icon", button_icon_name.c_str());
-	xfce_rc_write_bool_entry(rc, "button-single-row", button_single_row);
-	xfce_rc_write_bool_entry(rc, "show-button-title", button_title_visible);
-	xfce_rc_write_bool_entry(rc, "show-button-icon", button_icon_visible);
+	write_entry(contents, "button-title", button_title.c_str());
+	write_entry(contents, "button-icon", button_icon_name.c_str());
+	write_bool_entry(contents, "button-single-row", button_single_row);
+	write_bool_entry(contents, "show-button-title", button_title_visible);
+	write_bool_entry(contents, "show-button-icon", button_icon_visible);
 
-	xfce_rc_write_bool_entry(rc, "launcher-show-name", launcher_show_name);
-	xfce_rc_write_bool_entry(rc, "launcher-show-description", launcher_show_description);
-	xfce_rc_write_bool_entry(rc, "launcher-show-tooltip", launcher_show_tooltip);
-	xfce_rc_write_int_entry(rc, "item-icon-size", launcher_icon_size);
+	write_bool_entry(contents, "launcher-show-name", launcher_show_name);
+	write_bool_entry(contents, "launcher-show-description", launcher_show_description);
+	write_bool_entry(contents, "launcher-show-tooltip", launcher_show_tooltip);
+	write_bool_entry(contents, "launcher-prefetch", launcher_prefetch);
+	write_int_entry(contents, "item-icon-size", launcher_icon_size);
 
-	xfce_rc_write_bool_entry(rc, "hover-switch-category", category_hover_activate);
-	xfce_rc_write_bool_entry(rc, "category-show-name", category_show_name);
-	xfce_rc_write_int_entry(rc, "category-icon-size", category_icon_size);
+	write_bool_entry(contents, "hover-switch-category", category_hover_activate);
+	write_bool_entry(contents, "category-show-name", category_show_name);
+	write_int_entry(contents, "category-icon-size", category_icon_size);
 
-	xfce_rc_write_bool_entry(rc, "load-hierarchy", load_hierarchy);
+	write_bool_entry(contents, "load-hierarchy", load_hierarchy);
+	write_bool_entry(contents, "load-background", load_background);
+	write_bool_entry(contents, "search-transliterate", search_transliterate);
 
-	xfce_rc_write_int_entry(rc, "recent-items-max", recent_items_max);
-	xfce_rc_write_bool_entry(rc, "favorites-in-recent", favorites_in_recent);
-	xfce_rc_write_bool_entry(rc, "display-recent-default", display_recent);
+	write_int_entry(contents, "recent-items-max", recent_items_max);
+	write_bool_entry(contents, "favorites-in-recent", favorites_in_recent);
+	write_bool_entry(contents, "display-recent-default", display_recent);
 
-	xfce_rc_write_bool_entry(rc, "position-search-alternate", position_search_alternate);
-	xfce_rc_write_bool_entry(rc, "position-commands-alternate", position_commands_alternate);
-	xfce_rc_write_bool_entry(rc, "position-categories-alternate", position_categories_alternate);
+	write_bool_entry(contents, "position-search-alternate", position_search_alternate);
+	write_bool_entry(contents, "position-commands-alternate", position_commands_alternate);
+	write_bool_entry(contents, "position-categories-alternate", position_categories_alternate);
 
-	xfce_rc_write_int_entry(rc, "menu-width", menu_width);
-	xfce_rc_write_int_entry(rc, "menu-height", menu_height);
-	xfce_rc_write_int_entry(rc, "menu-opacity", menu_opacity);
+	write_int_entry(contents, "menu-width", menu_width);
+	write_int_entry(contents, "menu-height", menu_height);
+	write_int_entry(contents, "menu-opacity", menu_opacity);
 
 	for (int i = 0; i < CountCommands; ++i)
 	{
-		xfce_rc_write_entry(rc, settings_command[i][0], command[i]->get());
-		xfce_rc_write_bool_entry(rc, settings_command[i][1], command[i]->get_shown());
+		write_entry(contents, settings_command[i][0], command[i]->get());
+		write_bool_entry(contents, settings_command[i][1], command[i]->get_shown());
 	}
 
 	int actions_count = search_actions.size();
-	xfce_rc_write_int_entry(rc, "search-actions", actions_count);
+	write_int_entry(contents, "search-actions", actions_count);
 	for (int i = 0; i < actions_count; ++i)
 	{
 		gchar* key = g_strdup_printf("action%i", i);
-		xfce_rc_set_group(rc, key);
+		write_group(contents, key);
 		g_free(key);
 
 		const SearchAction* action = search_actions[i];
-		xfce_rc_write_entry(rc, "name", action->get_name());
-		xfce_rc_write_entry(rc, "pattern", action->get_pattern());
-		xfce_rc_write_entry(rc, "command", action->get_command());
-		xfce_rc_write_bool_entry(rc, "regex", action->get_is_regex());
+		write_entry(contents, "name", action->get_name());
+		write_entry(contents, "pattern", action->get_pattern());
+		write_entry(contents, "command", action->get_command());
+		write_bool_entry(contents, "regex", action->get_is_regex());
 	}
 
-	xfce_rc_close(rc);
+	// Replace settings file atomically, and only if anything changed
+	if (contents != m_contents)
+	{
+		m_writer->replace(file, contents);
+		m_contents = contents;
+	}
+	g_free(file);
 
 	m_modified = false;
 }
 
 //-----------------------------------------------------------------------------
+
+void Settings::save_journal(const char* file)
+{
+	// Compare against what is known to be on disk, which the writer thread
+	// updates after each successful write
+	std::string contents;
+	unsigned int lines = 0;
+	g_mutex_lock(&m_journal_mutex);
+	if (favorites != m_journal_favorites)
+	{
+		write_vector_entry(contents, "favorites", favorites);
+		++lines;
+	}
+	if (recent != m_journal_recent)
+	{
+		write_vector_entry(contents, "recent", recent);
+		++lines;
+	}
+	// The settings file does not hold the lists, so they are written in full
+	// until there is a journal; otherwise defaults would return on next load
+	const bool compact = !m_journal_exists || ((m_journal_lines + lines) > journal_lines_max);
+	g_mutex_unlock(&m_journal_mutex);
+	if (!lines && !compact)
+	{
+		return;
+	}
+
+	JournalWrite* write = new JournalWrite;
+	write->settings = this;
+	write->favorites = favorites;
+	write->recent = recent;
+	write->compact = compact;
+
+	gchar* journal = journal_file(file);
+
+	if (compact)
+	{
+		// Compact journal down to the current lists
+		contents.clear();
+		write_vector_entry(contents, "favorites", favorites);
+		write_vector_entry(contents, "recent", recent);
+		write->lines = 2;
+		m_writer->replace(journal, contents, &Settings::journal_written, write);
+	}
+	else
+	{
+		write->lines = lines;
+		m_writer->append(journal, contents, &Settings::journal_written, write);
+	}
+
+	g_free(journal);
+}
+
+//-----------------------------------------------------------------------------
+
+void Settings::journal_written(bool written, gpointer data)
+{
+	// A failed write leaves the last written lists in place, so the next
+	// save writes the changes again
+	JournalWrite* write = static_cast<JournalWrite*>(data);
+	Settings* settings = write->settings;
+	if (written)
+	{
+		g_mutex_lock(&settings->m_journal_mutex);
+		settings->m_journal_favorites.swap(write->favorites);
+		settings->m_journal_recent.swap(write->recent);
+		settings->m_journal_lines = write->compact ? write->lines : (settings->m_journal_lines + write->lines);
+		settings->m_journal_exists = true;
+		g_mutex_unlock(&settings->m_journal_mutex);
+	}
+	delete write;
+}
+
+//-----------------------------------------------------------------------------
+
+void Settings::remove_journal(const char* file)
+{
+	// Settings are deleted with the plugin, so stop saving them
+	m_removed = true;
+	m_writer->flush();
+
+	if (file)
+	{
+		gchar* journal = journal_file(file);
+		g_unlink(journal);
+		g_free(journal);
+	}
+}
+
+//-----------------------------------------------------------------------------
@@ -23,12 +23,16 @@
 #include <string>
 #include <vector>
 
+#include <glib.h>
+#include <libbladeutil/libbladeutil.h>
+
 namespace BladeMenu
 {
 
 class Command;
 class Plugin;
 class SearchAction;
+class SettingsWriter;
 
 class Settings
 {
@@ -37,12 +41,39 @@ class Settings
 	Settings& operator=(const Settings&);
 	~Settings();
 
-	void load(char* file);
+	void load_async(gchar* defaults_file, gchar* file, gchar* save_file, GSourceFunc callback, gpointer data);
+	void load(XfceRc* rc);
+	void load_journal(const gchar* contents);
 	void save(char* file);
+	void save_journal(const char* file);
+	void remove_journal(const char* file);
+
+	struct LoadRequest;
+	static gpointer load_thread(gpointer data);
+	static gboolean load_finished(gpointer data);
+	static void free_load_request(LoadRequest* request);
+
+	struct JournalWrite;
+	static void journal_written(bool written, gpointer data);
 
+	LoadRequest* m_load_request;
+	SettingsWriter* m_writer;
+	bool m_loaded;
 	bool m_modified;
+	bool m_removed;
+	std::string m_contents;
+	GMutex m_journal_mutex;
+	std::vector<std::string> m_journal_favorites;
+	std::vector<std::string> m_journal_recent;
+	unsigned int m_journal_lines;
+	bool m_journal_exists;
 
 public:
+	bool get_loaded() const
+	{
+		return m_loaded;
+	}
+
 	bool get_modified() const
 	{
 		return m_modified;
@@ -68,6 +99,7 @@ public:
 	bool launcher_show_name;
 	bool launcher_show_description;
 	bool launcher_show_tooltip;
+	bool launcher_prefetch;
 	IconSize launcher_icon_size;
 
 	bool category_hover_activate;
@@ -75,6 +107,8 @@ public:
 	IconSize category_icon_size;
 
 	bool load_hierarchy;
+	bool load_background;
+	bool search_transliterate;
 
 	unsigned int recent_items_max;
 	bool favorites_in_recent;
@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "spawner.h"
+
+#include <map>
+#include <string>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+
+#include <blxo/blxo.h>
+#include <libbladeui/libbladeui.h>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+// Programs found in PATH, which is cleared if PATH changes
+static std::map<std::string, std::string> program_cache;
+static std::string program_cache_path;
+
+// Files recently read ahead, to avoid repeating it while hovering
+static std::map<std::string, gint64> prefetch_times;
+static const gint64 prefetch_interval = 5 * 60 * G_USEC_PER_SEC;
+static const std::map<std::string, gint64>::size_type prefetch_times_max = 64;
+static GThreadPool* prefetch_pool = NULL;
+
+//-----------------------------------------------------------------------------
+
+static void child_exited(GPid pid, gint, gpointer)
+{
+	g_spawn_close_pid(pid);
+}
+
+//-----------------------------------------------------------------------------
+
+// Close every inherited descriptor above stderr in the child, since not all
+// of the libraries loaded into the bar open their files close-on-exec
+static bool close_inherited_fds(posix_spawn_file_actions_t* actions)
+{
+	GDir* dir = g_dir_open("/proc/self/fd", 0, NULL);
+	if (!dir)
+	{
+		return false;
+	}
+
+	const gchar* name;
+	while ((name = g_dir_read_name(dir)))
+	{
+		int fd = atoi(name);
+		if (fd <= STDERR_FILENO)
+		{
+			continue;
+		}
+
+		// Skips the descriptor used to read the directory, as well
+		int fd_flags = fcntl(fd, F_GETFD);
+		if ((fd_flags != -1) && !(fd_flags & FD_CLOEXEC))
+		{
+			posix_spawn_file_actions_addclose(actions, fd);
+		}
+	}
+	g_dir_close(dir);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static gchar* create_startup_id(GdkAppLaunchContext* context, const gchar* program)
+{
+	// The launch context only needs the program to name the sequence
+	gchar* command = g_shell_quote(program);
+	GAppInfo* info = g_app_info_create_from_commandline(command, NULL, G_APP_INFO_CREATE_SUPPORTS_STARTUP_NOTIFICATION, NULL);
+	g_free(command);
+	if (!info)
+	{
+		return NULL;
+	}
+
+	gchar* startup_id = g_app_launch_context_get_startup_notify_id(G_APP_LAUNCH_CONTEXT(context), info, NULL);
+	g_object_unref(info);
+	return startup_id;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool spawn(const gchar* program, const gchar* working_directory, gchar** argv, gchar** envp, GError** error)
+{
+	// Without a list of open descriptors they cannot be closed in the child,
+	// and without addchdir the child cannot change its folder before exec,
+	// so let GLib spawn it; GLib closes them, and double-forks the child so
+	// that it is reaped by init instead of the bar
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	bool spawnable = close_inherited_fds(&actions);
+	if (working_directory)
+	{
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCHDIR_NP
+		spawnable = spawnable && (posix_spawn_file_actions_addchdir_np(&actions, working_directory) == 0);
+#else
+		spawnable = false;
+#endif
+	}
+	if (!spawnable)
+	{
+		posix_spawn_file_actions_destroy(&actions);
+		return g_spawn_async(working_directory, argv, envp, G_SPAWN_SEARCH_PATH, NULL, NULL, NULL, error);
+	}
+
+	// Avoid copying the page tables of the bar process, and do not let the
+	// child inherit the signal mask or process group of the bar
+	posix_spawnattr_t attr;
+	posix_spawnattr_init(&attr);
+
+	sigset_t signals;
+	sigemptyset(&signals);
+	posix_spawnattr_setsigmask(&attr, &signals);
+	sigaddset(&signals, SIGPIPE);
+	posix_spawnattr_setsigdefault(&attr, &signals);
+	posix_spawnattr_setpgroup(&attr, 0);
+
+	short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETPGROUP;
+#ifdef POSIX_SPAWN_USEVFORK
+	flags |= POSIX_SPAWN_USEVFORK;
+#endif
+	posix_spawnattr_setflags(&attr, flags);
+
+	pid_t pid;
+	int status = posix_spawn(&pid, program, &actions, &attr, argv, envp);
+
+	posix_spawnattr_destroy(&attr);
+	posix_spawn_file_actions_destroy(&actions);
+
+	if (status != 0)
+	{
+		g_set_error(error, G_SPAWN_ERROR, G_SPAWN_ERROR_FAILED,
+				_("Failed to execute child process \"%s\" (%s)"), argv[0], g_strerror(status));
+		return false;
+	}
+
+	// The child is not double-forked, so it stays a child of the bar until
+	// it exits; the child watch reaps it then to avoid leaving a zombie
+	g_child_watch_add(pid, &child_exited, NULL);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static void prefetch_file(gchar* path, gpointer)
+{
+	// Ask the kernel to start reading the file into the page cache
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd != -1)
+	{
+#ifdef POSIX_FADV_WILLNEED
+		posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+		close(fd);
+	}
+	g_free(path);
+}
+
+//-----------------------------------------------------------------------------
+
+gchar* Spawner::find_program(const gchar* program)
+{
+	if (blxo_str_is_empty(program))
+	{
+		return NULL;
+	}
+
+	// Only cache lookups that search PATH
+	if (strchr(program, G_DIR_SEPARATOR))
+	{
+		return g_find_program_in_path(program);
+	}
+
+	const gchar* path = g_getenv("PATH");
+	if (program_cache_path != (path ? path : ""))
+	{
+		program_cache.clear();
+		program_cache_path = path ? path : "";
+	}
+
+	std::map<std::string, std::string>::iterator i = program_cache.find(program);
+	if ((i != program_cache.end()) && g_file_test(i->second.c_str(), G_FILE_TEST_IS_EXECUTABLE))
+	{
+		return g_strdup(i->second.c_str());
+	}
+
+	gchar* result = g_find_program_in_path(program);
+	if (result)
+	{
+		program_cache[program] = result;
+	}
+	else if (i != program_cache.end())
+	{
+		program_cache.erase(i);
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+
+void Spawner::prefetch(const gchar* path)
+{
+	if (blxo_str_is_empty(path))
+	{
+		return;
+	}
+
+	// Forget files read ahead long enough ago that they may be evicted
+	const gint64 now = g_get_monotonic_time();
+	if (prefetch_times.size() >= prefetch_times_max)
+	{
+		for (std::map<std::string, gint64>::iterator i = prefetch_times.begin(); i != prefetch_times.end();)
+		{
+			if ((now - i->second) >= prefetch_interval)
+			{
+				prefetch_times.erase(i++);
+			}
+			else
+			{
+				++i;
+			}
+		}
+		if (prefetch_times.size() >= prefetch_times_max)
+		{
+			prefetch_times.clear();
+		}
+	}
+
+	gint64& time = prefetch_times[path];
+	if (time && ((now - time) < prefetch_interval))
+	{
+		return;
+	}
+	time = now;
+
+	// Opening the file can block on slow disks, so keep it off the main thread
+	if (!prefetch_pool)
+	{
+		prefetch_pool = g_thread_pool_new((GFunc)&prefetch_file, NULL, 1, false, NULL);
+	}
+	g_thread_pool_push(prefetch_pool, g_strdup(path), NULL);
+}
+
+//-----------------------------------------------------------------------------
+
+bool Spawner::run(GdkScreen* screen, const gchar* command_line, GError** error)
+{
+	gchar** argv;
+	if (!g_shell_parse_argv(command_line, NULL, &argv, error))
+	{
+		return false;
+	}
+
+	bool result = run(screen, NULL, argv, false, NULL, error);
+	g_strfreev(argv);
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+
+bool Spawner::run(GdkScreen* screen, const gchar* working_directory, gchar** argv,
+		bool startup_notify, const gchar* icon_name, GError** error)
+{
+	gchar* program = find_program(argv[0]);
+	if (!program)
+	{
+		g_set_error(error, G_SPAWN_ERROR, G_SPAWN_ERROR_NOENT,
+				_("Failed to execute child process \"%s\" (%s)"), argv[0], g_strerror(ENOENT));
+		return false;
+	}
+
+	// Start child on the same screen as the menu
+	gchar** envp = g_get_environ();
+	if (screen)
+	{
+		gchar* display = gdk_screen_make_display_name(screen);
+		envp = g_environ_setenv(envp, "DISPLAY", display, true);
+		g_free(display);
+	}
+
+	// Announce the launch the same way as xfce_spawn_on_screen, and pass
+	// the id of the startup sequence to the child
+	GdkAppLaunchContext* context = NULL;
+	gchar* startup_id = NULL;
+	if (startup_notify)
+	{
+		context = gdk_app_launch_context_new();
+		if (screen)
+		{
+			gdk_app_launch_context_set_screen(context, screen);
+		}
+		gdk_app_launch_context_set_timestamp(context, gtk_get_current_event_time());
+		gdk_app_launch_context_set_icon_name(context, icon_name);
+
+		startup_id = create_startup_id(context, argv[0]);
+		if (startup_id)
+		{
+			envp = g_environ_setenv(envp, "DESKTOP_STARTUP_ID", startup_id, true);
+		}
+	}
+
+	if (blxo_str_is_empty(working_directory))
+	{
+		working_directory = NULL;
+	}
+	bool result = spawn(program, working_directory, argv, envp, error);
+
+	// End the startup sequence right away if nothing was started
+	if (startup_id && !result)
+	{
+		g_app_launch_context_launch_failed(G_APP_LAUNCH_CONTEXT(context), startup_id);
+	}
+	g_free(startup_id);
+	if (context)
+	{
+		g_object_unref(context);
+	}
+
+	g_strfreev(envp);
+	g_free(program);
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------
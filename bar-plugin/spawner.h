@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_SPAWNER_H
+#define BLADEMENU_SPAWNER_H
+
+#include <gtk/gtk.h>
+
+namespace BladeMenu
+{
+
+class Spawner
+{
+public:
+	static gchar* find_program(const gchar* program);
+	static void prefetch(const gchar* path);
+	static bool run(GdkScreen* screen, const gchar* command_line, GError** error);
+	static bool run(GdkScreen* screen, const gchar* working_directory, gchar** argv,
+			bool startup_notify, const gchar* icon_name, GError** error);
+};
+
+}
+
+#endif // BLADEMENU_SPAWNER_H
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "token-dictionary.h"
+
+#include "memory-report.h"
+#include "query.h"
+
+#include <algorithm>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+// Marks a token that has not been matched against the cached query yet
+static const unsigned int match_unknown = G_MAXUINT - 1;
+
+//-----------------------------------------------------------------------------
+
+TokenDictionary::TokenDictionary() :
+	m_cached_serial(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+
+void TokenDictionary::clear()
+{
+	m_tokens.clear();
+	m_ids.clear();
+	m_cached_serial = 0;
+	m_cached_matches.clear();
+}
+
+//-----------------------------------------------------------------------------
+
+guint32 TokenDictionary::insert(const std::string& token)
+{
+	std::map<std::string, guint32>::const_iterator i = m_ids.find(token);
+	if (i != m_ids.end())
+	{
+		return i->second;
+	}
+
+	guint32 id = m_tokens.size();
+	m_tokens.push_back(SearchText());
+	m_tokens.back() = token;
+	m_ids.insert(std::make_pair(token, id));
+	m_cached_matches.push_back(match_unknown);
+	return id;
+}
+
+//-----------------------------------------------------------------------------
+
+unsigned int TokenDictionary::match(const Query& query, const std::vector<guint32>& tokens) const
+{
+	unsigned int result = G_MAXUINT;
+	for (std::vector<guint32>::const_iterator i = tokens.begin(), end = tokens.end(); i != end; ++i)
+	{
+		result = std::min(result, match(query, *i));
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+
+void TokenDictionary::measure(MemoryReport& report) const
+{
+	// Each token is stored twice, once in the list and once as a map key
+	report.add_vector(MemoryReport::SearchIndex, m_tokens);
+	report.add_map(MemoryReport::SearchIndex, m_ids);
+	for (std::vector<SearchText>::const_iterator i = m_tokens.begin(), end = m_tokens.end(); i != end; ++i)
+	{
+		report.add(MemoryReport::SearchIndex, i->get_size());
+		report.add_string(MemoryReport::SearchIndex, i->str());
+	}
+	report.add_vector(MemoryReport::SearchIndex, m_cached_matches);
+}
+
+//-----------------------------------------------------------------------------
+
+unsigned int TokenDictionary::match(const Query& query, guint32 token) const
+{
+	// Tokens are shared between launchers, so only match each once per query
+	if (m_cached_serial != query.get_serial())
+	{
+		m_cached_serial = query.get_serial();
+		m_cached_matches.assign(m_tokens.size(), match_unknown);
+	}
+
+	unsigned int& result = m_cached_matches[token];
+	if (result == match_unknown)
+	{
+		result = query.match(m_tokens[token]);
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_TOKEN_DICTIONARY_H
+#define BLADEMENU_TOKEN_DICTIONARY_H
+
+#include "search-text.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+namespace BladeMenu
+{
+
+class MemoryReport;
+class Query;
+
+class TokenDictionary
+{
+public:
+	TokenDictionary();
+
+	void clear();
+	guint32 insert(const std::string& token);
+	unsigned int match(const Query& query, const std::vector<guint32>& tokens) const;
+	void measure(MemoryReport& report) const;
+
+	std::vector<SearchText>::size_type size() const
+	{
+		return m_tokens.size();
+	}
+
+private:
+	unsigned int match(const Query& query, guint32 token) const;
+
+private:
+	std::vector<SearchText> m_tokens;
+	std::map<std::string, guint32> m_ids;
+	mutable unsigned int m_cached_serial;
+	mutable std::vector<unsigned int> m_cached_matches;
+};
+
+}
+
+#endif // BLADEMENU_TOKEN_DICTIONARY_H
@@ -0,0 +1,492 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "transliteration.h"
+
+#include <cstring>
+
+#include <glib.h>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+// Longest romanized string kept for a launcher field
+static const std::string::size_type romanized_length_max = 255;
+
+// Hepburn romanization of hiragana U+3041 to U+3096; katakana are mapped
+// onto these, and small tsu is handled separately
+static const char* const kana_table[] = {
+	"a", "a", "i", "i", "u", "u", "e", "e", "o", "o",
+	"ka", "ga", "ki", "gi", "ku", "gu", "ke", "ge", "ko", "go",
+	"sa", "za", "shi", "ji", "su", "zu", "se", "ze", "so", "zo",
+	"ta", "da", "chi", "ji", "", "tsu", "zu", "te", "de", "to", "do",
+	"na", "ni", "nu", "ne", "no",
+	"ha", "ba", "pa", "hi", "bi", "pi", "fu", "bu", "pu",
+	"he", "be", "pe", "ho", "bo", "po",
+	"ma", "mi", "mu", "me", "mo",
+	"ya", "ya", "yu", "yu", "yo", "yo",
+	"ra", "ri", "ru", "re", "ro",
+	"wa", "wa", "i", "e", "o", "n", "vu", "ka", "ke"
+};
+
+static const char* const katakana_v_table[] = { "va", "vi", "ve", "vo" };
+
+// Pinyin syllables without tones; ü is written as v
+static const char* const pinyin_syllables[] = {
+	"a", "ai", "an", "ba", "bai", "ban", "bang", "bao", "bei", "ben", "bi",
+	"bian", "biao", "bie", "bing", "bo", "bu", "cai", "can", "cang", "cao",
+	"ce", "ceng", "cha", "chang", "che", "cheng", "chi", "chong", "chu",
+	"chuan", "chuang", "ci", "cong", "cun", "cuo", "da", "dai", "dan", "dang",
+	"dao", "de", "deng", "di", "dian", "die", "ding", "dong", "dou", "du",
+	"duan", "dui", "duo", "e", "er", "fa", "fan", "fang", "fei", "fen", "feng",
+	"fou", "fu", "gai", "gao", "ge", "gei", "geng", "gong", "gou", "gu", "gua",
+	"guan", "guang", "gui", "gun", "guo", "hai", "han", "hang", "hao", "he",
+	"hei", "heng", "hong", "hou", "hu", "hua", "huai", "huan", "huang", "hui",
+	"hun", "huo", "ji", "jia", "jian", "jiang", "jiao", "jie", "jin", "jing",
+	"jiu", "ju", "juan", "jue", "jun", "ka", "kai", "kan", "kao", "ke", "kong",
+	"kou", "ku", "kuai", "kuang", "kui", "la", "lai", "lan", "lang", "lao",
+	"le", "lei", "li", "lian", "liang", "liao", "lie", "lin", "ling", "liu",
+	"long", "lou", "lu", "lun", "luo", "lv", "lve", "ma", "mai", "mang", "mao",
+	"me", "mei", "men", "mi", "mian", "miao", "ming", "mo", "mu", "na", "nan",
+	"nao", "nei", "neng", "ni", "niao", "niu", "nv", "pai", "pan", "pang",
+	"pei", "peng", "pi", "pian", "piao", "pin", "ping", "pu", "qi", "qian",
+	"qiang", "qie", "qin", "qing", "qiu", "qu", "quan", "que", "qun", "rang",
+	"re", "ren", "ri", "rong", "ru", "ruan", "sai", "san", "sao", "se", "sen",
+	"sha", "shai", "shan", "shang", "shao", "she", "shen", "sheng", "shi",
+	"shou", "shu", "shua", "shui", "shuo", "si", "song", "sou", "su", "suan",
+	"suo", "ta", "tai", "tan", "tao", "te", "teng", "ti", "tian", "tiao",
+	"tie", "ting", "tong", "tou", "tu", "tuan", "tui", "wai", "wang", "wei",
+	"wen", "wo", "wu", "xi", "xia", "xian", "xiang", "xiao", "xie", "xin",
+	"xing", "xiong", "xiu", "xu", "xuan", "xue", "xun", "ya", "yan", "yang",
+	"yao", "ye", "yi", "yin", "ying", "yong", "you", "yu", "yuan", "yue",
+	"yun", "za", "zai", "zan", "zao", "ze", "zen", "zeng", "zhan", "zhang",
+	"zhao", "zhe", "zhen", "zheng", "zhi", "zhong", "zhou", "zhu", "zhuan",
+	"zhuang", "zhun", "zhuo", "zi", "zong", "zu", "zui", "zuo"
+};
+
+// Common Han characters in application names, sorted by code point
+static const struct { guint16 codepoint; guint16 syllable; } pinyin_table[] = {
+	{ 0x4E00, 257 }, { 0x4E01, 46 }, { 0x4E03, 173 }, { 0x4E09, 192 },
+	{ 0x4E0A, 199 }, { 0x4E0B, 239 }, { 0x4E0D, 16 }, { 0x4E0E, 262 },
+	{ 0x4E13, 283 }, { 0x4E16, 204 }, { 0x4E1A, 256 }, { 0x4E1C, 47 },
+	{ 0x4E2A, 65 }, { 0x4E2D, 280 }, { 0x4E3A, 234 }, { 0x4E3B, 282 },
+	{ 0x4E48, 144 }, { 0x4E49, 257 }, { 0x4E4B, 279 }, { 0x4E4E, 86 },
+	{ 0x4E50, 264 }, { 0x4E52, 171 }, { 0x4E53, 164 }, { 0x4E5D, 102 },
+	{ 0x4E60, 238 }, { 0x4E66, 206 }, { 0x4E70, 141 }, { 0x4E86, 123 },
+	{ 0x4E8B, 204 }, { 0x4E8C, 54 }, { 0x4E8E, 262 }, { 0x4E91, 265 },
+	{ 0x4E94, 237 }, { 0x4E9B, 243 }, { 0x4EA4, 98 }, { 0x4EAB, 241 },
+	{ 0x4EAC, 101 }, { 0x4EAE, 127 }, { 0x4EB2, 177 }, { 0x4EBA, 186 },
+	{ 0x4EC0, 202 }, { 0x4ECE, 33 }, { 0x4ED6, 216 }, { 0x4ED8, 62 },
+	{ 0x4EE3, 37 }, { 0x4EE4, 131 }, { 0x4EE5, 257 }, { 0x4EEA, 257 },
+	{ 0x4EEC, 146 }, { 0x4EF6, 96 }, { 0x4EF7, 95 }, { 0x4EFB, 186 },
+	{ 0x4EFD, 59 }, { 0x4EFF, 57 }, { 0x4F01, 173 }, { 0x4F11, 247 },
+	{ 0x4F18, 261 }, { 0x4F1A, 91 }, { 0x4F20, 30 }, { 0x4F53, 222 },
+	{ 0x4F5C, 291 }, { 0x4F60, 158 }, { 0x4F7F, 204 }, { 0x4FBF, 11 },
+	{ 0x4FC4, 53 }, { 0x4FDD, 7 }, { 0x4FE1, 244 }, { 0x4FEE, 247 },
+	{ 0x5012, 40 }, { 0x501F, 99 }, { 0x503C, 279 }, { 0x5047, 95 },
+	{ 0x504F, 168 }, { 0x505A, 291 }, { 0x505C, 226 }, { 0x50A8, 29 },
+	{ 0x50CF, 241 }, { 0x513F, 54 }, { 0x5141, 265 }, { 0x5143, 263 },
+	{ 0x5145, 28 }, { 0x5149, 73 }, { 0x514B, 111 }, { 0x514D, 148 },
+	{ 0x5154, 229 }, { 0x5165, 189 }, { 0x5168, 181 }, { 0x516B, 3 },
+	{ 0x516C, 68 }, { 0x516D, 132 }, { 0x5171, 68 }, { 0x5173, 72 },
+	{ 0x5176, 173 }, { 0x5177, 103 }, { 0x5178, 44 }, { 0x5185, 156 },
+	{ 0x518C, 21 }, { 0x5192, 143 }, { 0x5199, 243 }, { 0x51B2, 28 },
+	{ 0x51C6, 285 }, { 0x51CF, 96 }, { 0x51FA, 29 }, { 0x51FB, 94 },
+	{ 0x5206, 59 }, { 0x5207, 176 }, { 0x5217, 129 }, { 0x521B, 31 },
+	{ 0x5220, 198 }, { 0x522B, 13 }, { 0x5230, 40 }, { 0x5236, 279 },
+	{ 0x5237, 207 }, { 0x5238, 181 }, { 0x523B, 111 }, { 0x524D, 174 },
+	{ 0x526A, 96 }, { 0x529B, 125 }, { 0x529E, 5 }, { 0x529F, 68 },
+	{ 0x52A0, 95 }, { 0x52A1, 237 }, { 0x52A8, 47 }, { 0x52A9, 282 },
+	{ 0x5305, 7 }, { 0x5316, 87 }, { 0x533A, 180 }, { 0x5341, 204 },
+	{ 0x5347, 203 }, { 0x534E, 87 }, { 0x5355, 38 }, { 0x5356, 141 },
+	{ 0x535A, 15 }, { 0x5361, 107 }, { 0x536B, 234 }, { 0x5370, 258 },
+	{ 0x5377, 104 }, { 0x5378, 243 }, { 0x5382, 24 }, { 0x5385, 226 },
+	{ 0x5386, 125 }, { 0x538B, 252 }, { 0x539F, 263 }, { 0x53BB, 180 },
+	{ 0x53CA, 94 }, { 0x53CB, 261 }, { 0x53CD, 56 }, { 0x53D1, 55 },
+	{ 0x53D6, 180 }, { 0x53D7, 205 }, { 0x53D8, 11 }, { 0x53E3, 113 },
+	{ 0x53E6, 131 }, { 0x53EA, 279 }, { 0x53EF, 111 }, { 0x53F0, 217 },
+	{ 0x53F3, 261 }, { 0x53F7, 80 }, { 0x53F8, 210 }, { 0x5404, 65 },
+	{ 0x5408, 81 }, { 0x540C, 227 }, { 0x540D, 150 }, { 0x540E, 85 },
+	{ 0x5411, 241 }, { 0x5426, 61 }, { 0x5427, 3 }, { 0x542C, 226 },
+	{ 0x542F, 173 }, { 0x544A, 64 }, { 0x5458, 263 }, { 0x547D, 150 },
+	{ 0x548C, 81 }, { 0x54D4, 10 }, { 0x54E9, 125 }, { 0x54EA, 153 },
+	{ 0x5531, 24 }, { 0x5546, 199 }, { 0x559C, 238 }, { 0x5668, 173 },
+	{ 0x56DB, 210 }, { 0x56DE, 91 }, { 0x56E2, 230 }, { 0x56ED, 263 },
+	{ 0x56F4, 234 }, { 0x56FD, 76 }, { 0x56FE, 229 }, { 0x5708, 181 },
+	{ 0x571F, 229 }, { 0x5728, 267 }, { 0x5730, 43 }, { 0x573A, 24 },
+	{ 0x573E, 94 }, { 0x5747, 106 }, { 0x574F, 88 }, { 0x5757, 115 },
+	{ 0x575B, 218 }, { 0x5783, 118 }, { 0x578B, 245 }, { 0x57CE, 26 },
+	{ 0x57DF, 262 }, { 0x57FA, 94 }, { 0x5883, 101 }, { 0x5899, 175 },
+	{ 0x589E, 272 }, { 0x58C1, 10 }, { 0x58EB, 204 }, { 0x58F0, 203 },
+	{ 0x5904, 29 }, { 0x5907, 8 }, { 0x590D, 62 }, { 0x5916, 232 },
+	{ 0x591A, 52 }, { 0x5927, 36 }, { 0x5929, 223 }, { 0x592B, 62 },
+	{ 0x5934, 228 }, { 0x5939, 95 }, { 0x5947, 173 }, { 0x5973, 161 },
+	{ 0x5979, 216 }, { 0x597D, 80 }, { 0x59CB, 204 }, { 0x5A92, 145 },
+	{ 0x5B50, 287 }, { 0x5B57, 287 }, { 0x5B58, 34 }, { 0x5B66, 250 },
+	{ 0x5B69, 77 }, { 0x5B83, 216 }, { 0x5B89, 2 }, { 0x5B9A, 46 },
+	{ 0x5B9D, 7 }, { 0x5B9E, 204 }, { 0x5BA2, 111 }, { 0x5BA4, 204 },
+	{ 0x5BAB, 68 }, { 0x5BB6, 95 }, { 0x5BB9, 188 }, { 0x5BC6, 147 },
+	{ 0x5BF9, 51 }, { 0x5BFC, 40 }, { 0x5C04, 201 }, { 0x5C06, 97 },
+	{ 0x5C0F, 242 }, { 0x5C11, 200 }, { 0x5C14, 54 }, { 0x5C40, 103 },
+	{ 0x5C42, 22 }, { 0x5C45, 103 }, { 0x5C4B, 237 }, { 0x5C4F, 171 },
+	{ 0x5C5E, 206 }, { 0x5C71, 198 }, { 0x5DE5, 68 }, { 0x5DE6, 291 },
+	{ 0x5DF2, 257 }, { 0x5E02, 204 }, { 0x5E03, 16 }, { 0x5E08, 204 },
+	{ 0x5E2E, 6 }, { 0x5E38, 24 }, { 0x5E55, 152 }, { 0x5E73, 171 },
+	{ 0x5E7F, 73 }, { 0x5E8F, 248 }, { 0x5E93, 114 }, { 0x5E94, 259 },
+	{ 0x5E97, 44 }, { 0x5E9F, 58 }, { 0x5EA6, 49 }, { 0x5EAD, 226 },
+	{ 0x5EFA, 96 }, { 0x5F00, 108 }, { 0x5F0F, 204 }, { 0x5F20, 274 },
+	{ 0x5F39, 218 }, { 0x5F52, 74 }, { 0x5F53, 39 }, { 0x5F55, 135 },
+	{ 0x5F62, 245 }, { 0x5F71, 259 }, { 0x5F80, 233 }, { 0x5F84, 101 },
+	{ 0x5F85, 37 }, { 0x5FAE, 234 }, { 0x5FB7, 41 }, { 0x5FC3, 244 },
+	{ 0x5FD7, 279 }, { 0x5FD8, 233 }, { 0x5FEB, 115 }, { 0x6001, 217 },
+	{ 0x600E, 271 }, { 0x6027, 245 }, { 0x6062, 91 }, { 0x606F, 238 },
+	{ 0x60E0, 91 }, { 0x60F3, 241 }, { 0x610F, 257 }, { 0x61C2, 47 },
+	{ 0x620F, 238 }, { 0x6210, 26 }, { 0x6211, 236 }, { 0x6216, 93 },
+	{ 0x621A, 173 }, { 0x622A, 99 }, { 0x6234, 37 }, { 0x6237, 86 },
+	{ 0x623F, 57 }, { 0x6240, 215 }, { 0x6247, 198 }, { 0x624B, 205 },
+	{ 0x6251, 172 }, { 0x6253, 36 }, { 0x6267, 279 }, { 0x626B, 193 },
+	{ 0x626E, 5 }, { 0x6279, 167 }, { 0x627E, 275 }, { 0x628A, 3 },
+	{ 0x6295, 228 }, { 0x6296, 48 }, { 0x62A4, 86 }, { 0x62A5, 7 },
+	{ 0x62C9, 118 }, { 0x62D2, 103 }, { 0x62DF, 158 }, { 0x62E9, 270 },
+	{ 0x62FC, 170 }, { 0x62FF, 153 }, { 0x6302, 71 }, { 0x6307, 279 },
+	{ 0x6309, 2 }, { 0x6362, 89 }, { 0x636E, 103 }, { 0x6377, 99 },
+	{ 0x6392, 162 }, { 0x63A5, 99 }, { 0x63A7, 112 }, { 0x63A8, 231 },
+	{ 0x63CF, 149 }, { 0x63D0, 222 }, { 0x641C, 212 }, { 0x6478, 151 },
+	{ 0x64A4, 25 }, { 0x64AD, 15 }, { 0x652F, 279 }, { 0x6536, 205 },
+	{ 0x6539, 63 }, { 0x653E, 57 }, { 0x6548, 242 }, { 0x6559, 98 },
+	{ 0x6570, 206 }, { 0x6587, 235 }, { 0x65AF, 210 }, { 0x65B0, 244 },
+	{ 0x65B9, 57 }, { 0x65C5, 138 }, { 0x65CF, 289 }, { 0x65D7, 173 },
+	{ 0x65E0, 237 }, { 0x65E5, 187 }, { 0x65E7, 102 }, { 0x65F6, 204 },
+	{ 0x6613, 257 }, { 0x661F, 245 }, { 0x6620, 259 }, { 0x662F, 204 },
+	{ 0x663E, 240 }, { 0x666E, 172 }, { 0x666F, 101 }, { 0x667A, 279 },
+	{ 0x6682, 268 }, { 0x6697, 2 }, { 0x66F2, 180 }, { 0x66F4, 67 },
+	{ 0x66FF, 222 }, { 0x6700, 290 }, { 0x6708, 264 }, { 0x6709, 261 },
+	{ 0x670B, 166 }, { 0x670D, 62 }, { 0x6717, 121 }, { 0x671F, 173 },
+	{ 0x6728, 152 }, { 0x672C, 9 }, { 0x673A, 94 }, { 0x6740, 196 },
+	{ 0x6742, 266 }, { 0x6743, 181 }, { 0x675F, 206 }, { 0x6761, 224 },
+	{ 0x6765, 119 }, { 0x677F, 5 }, { 0x6790, 238 }, { 0x6797, 130 },
+	{ 0x679C, 76 }, { 0x67E5, 23 }, { 0x6807, 12 }, { 0x680F, 120 },
+	{ 0x6811, 206 }, { 0x6837, 254 }, { 0x6838, 81 }, { 0x683C, 65 },
+	{ 0x6846, 116 }, { 0x684C, 286 }, { 0x6863, 39 }, { 0x68C0, 96 },
+	{ 0x68CB, 173 }, { 0x68D5, 288 }, { 0x68EE, 195 }, { 0x697C, 134 },
+	{ 0x699C, 6 }, { 0x6A21, 151 }, { 0x6A59, 26 }, { 0x6B21, 32 },
+	{ 0x6B22, 89 }, { 0x6B4C, 65 }, { 0x6B62, 279 }, { 0x6B63, 278 },
+	{ 0x6B65, 16 }, { 0x6BB5, 50 }, { 0x6BCD, 152 }, { 0x6BCF, 145 },
+	{ 0x6BD2, 49 }, { 0x6BDB, 143 }, { 0x6C14, 173 }, { 0x6C49, 78 },
+	{ 0x6C5F, 97 }, { 0x6C60, 27 }, { 0x6C7D, 173 }, { 0x6CA1, 145 },
+	{ 0x6CB3, 81 }, { 0x6CD5, 55 }, { 0x6CE8, 282 }, { 0x6D41, 132 },
+	{ 0x6D45, 174 }, { 0x6D4B, 21 }, { 0x6D4F, 132 }, { 0x6D6A, 121 },
+	{ 0x6D77, 77 }, { 0x6D88, 242 }, { 0x6DD8, 219 }, { 0x6DF1, 202 },
+	{ 0x6DF7, 92 }, { 0x6DFB, 223 }, { 0x6E05, 178 }, { 0x6E29, 235 },
+	{ 0x6E38, 261 }, { 0x6E56, 86 }, { 0x6E90, 263 }, { 0x6ED1, 87 },
+	{ 0x6EDA, 75 }, { 0x6EE4, 138 }, { 0x6EF4, 43 }, { 0x6F14, 253 },
+	{ 0x706B, 93 }, { 0x7070, 91 }, { 0x70B9, 44 }, { 0x70ED, 185 },
+	{ 0x7167, 275 }, { 0x718A, 246 }, { 0x7231, 1 }, { 0x7236, 62 },
+	{ 0x7247, 168 }, { 0x7248, 5 }, { 0x724C, 162 }, { 0x7259, 252 },
+	{ 0x725B, 160 }, { 0x7269, 237 }, { 0x7279, 220 }, { 0x72B6, 284 },
+	{ 0x72D0, 86 }, { 0x72D7, 69 }, { 0x72EC, 49 }, { 0x72F8, 125 },
+	{ 0x732A, 282 }, { 0x732B, 143 }, { 0x7334, 85 }, { 0x73AF, 89 },
+	{ 0x73B0, 240 }, { 0x73ED, 5 }, { 0x7403, 179 }, { 0x7406, 125 },
+	{ 0x74E3, 5 }, { 0x751F, 203 }, { 0x7528, 260 }, { 0x7535, 44 },
+	{ 0x7537, 154 }, { 0x753B, 87 }, { 0x754C, 99 }, { 0x7565, 139 },
+	{ 0x75C5, 14 }, { 0x767B, 42 }, { 0x767D, 4 }, { 0x767E, 4 },
+	{ 0x7684, 41 }, { 0x76CA, 257 }, { 0x76D1, 96 }, { 0x76D8, 163 },
+	{ 0x76EE, 152 }, { 0x76F4, 279 }, { 0x76F8, 241 }, { 0x7701, 203 },
+	{ 0x770B, 109 }, { 0x771F, 277 }, { 0x7720, 148 }, { 0x7740, 276 },
+	{ 0x77E5, 279 }, { 0x77ED, 50 }, { 0x7801, 140 }, { 0x786C, 259 },
+	{ 0x786E, 182 }, { 0x789F, 45 }, { 0x78C1, 32 }, { 0x793A, 204 },
+	{ 0x793E, 201 }, { 0x7968, 169 }, { 0x7981, 100 }, { 0x79C1, 210 },
+	{ 0x79CD, 280 }, { 0x79D1, 111 }, { 0x79D2, 149 }, { 0x79FB, 257 },
+	{ 0x7A0B, 26 }, { 0x7A0E, 208 }, { 0x7A3F, 64 }, { 0x7A7A, 112 },
+	{ 0x7A97, 31 }, { 0x7AD9, 273 }, { 0x7AE0, 274 }, { 0x7AEF, 50 },
+	{ 0x7B14, 10 }, { 0x7B49, 42 }, { 0x7B54, 36 }, { 0x7B56, 21 },
+	{ 0x7B5B, 197 }, { 0x7B7E, 174 }, { 0x7B97, 214 }, { 0x7BA1, 72 },
+	{ 0x7BB1, 241 }, { 0x7BC7, 168 }, { 0x7BD3, 134 }, { 0x7BEE, 120 },
+	{ 0x7C73, 147 }, { 0x7C7B, 124 }, { 0x7C89, 59 }, { 0x7C98, 273 },
+	{ 0x7CFB, 238 }, { 0x7D22, 215 }, { 0x7D2B, 287 }, { 0x7EA2, 84 },
+	{ 0x7EA7, 94 }, { 0x7EB8, 279 }, { 0x7EBF, 240 }, { 0x7EC3, 126 },
+	{ 0x7EC4, 289 }, { 0x7EC8, 280 }, { 0x7ECF, 101 }, { 0x7ED3, 99 },
+	{ 0x7ED8, 91 }, { 0x7ED9, 66 }, { 0x7EDC, 137 }, { 0x7EDD, 105 },
+	{ 0x7EDF, 227 }, { 0x7EE7, 94 }, { 0x7EED, 248 }, { 0x7EF4, 234 },
+	{ 0x7EFF, 138 }, { 0x7F16, 11 }, { 0x7F29, 215 }, { 0x7F51, 233 },
+	{ 0x7F57, 137 }, { 0x7F6E, 279 }, { 0x7F8A, 254 }, { 0x7F8E, 145 },
+	{ 0x7FA4, 183 }, { 0x7FBD, 262 }, { 0x7FFB, 56 }, { 0x8001, 122 },
+	{ 0x8003, 110 }, { 0x804A, 128 }, { 0x8054, 126 }, { 0x80A1, 70 },
+	{ 0x80B2, 262 }, { 0x80CC, 8 }, { 0x80FD, 157 }, { 0x8111, 155 },
+	{ 0x811A, 98 }, { 0x817E, 221 }, { 0x81EA, 287 }, { 0x822A, 79 },
+	{ 0x8239, 30 }, { 0x8272, 194 }, { 0x827A, 257 }, { 0x8282, 99 },
+	{ 0x8292, 142 }, { 0x82AF, 244 }, { 0x82B1, 87 }, { 0x82F1, 259 },
+	{ 0x8349, 20 }, { 0x8350, 96 }, { 0x83DC, 17 }, { 0x84DD, 120 },
+	{ 0x85CF, 19 }, { 0x864E, 86 }, { 0x865A, 248 }, { 0x867E, 239 },
+	{ 0x86C7, 201 }, { 0x86DB, 282 }, { 0x8718, 279 }, { 0x884C, 245 },
+	{ 0x8861, 83 }, { 0x8865, 16 }, { 0x8868, 12 }, { 0x88AB, 8 },
+	{ 0x88C5, 284 }, { 0x8981, 255 }, { 0x89C1, 96 }, { 0x89C2, 72 },
+	{ 0x89C6, 204 }, { 0x89C8, 120 }, { 0x89D2, 98 }, { 0x89E3, 99 },
+	{ 0x89E6, 29 }, { 0x8A00, 253 }, { 0x8B66, 101 }, { 0x8BA1, 94 },
+	{ 0x8BA2, 46 }, { 0x8BA4, 186 }, { 0x8BA9, 184 }, { 0x8BAE, 257 },
+	{ 0x8BAF, 251 }, { 0x8BB0, 94 }, { 0x8BB2, 97 }, { 0x8BB8, 248 },
+	{ 0x8BBA, 136 }, { 0x8BBE, 201 }, { 0x8BBF, 57 }, { 0x8BC1, 278 },
+	{ 0x8BC6, 204 }, { 0x8BCD, 32 }, { 0x8BD1, 257 }, { 0x8BD5, 204 },
+	{ 0x8BDD, 87 }, { 0x8BED, 262 }, { 0x8BEF, 237 }, { 0x8BF4, 209 },
+	{ 0x8BFB, 49 }, { 0x8BFE, 111 }, { 0x8C01, 208 }, { 0x8C03, 224 },
+	{ 0x8C31, 172 }, { 0x8C37, 70 }, { 0x8C46, 48 }, { 0x8C61, 241 },
+	{ 0x8D22, 17 }, { 0x8D26, 274 }, { 0x8D2D, 69 }, { 0x8D34, 225 },
+	{ 0x8D39, 58 }, { 0x8D44, 287 }, { 0x8D5B, 191 }, { 0x8D77, 173 },
+	{ 0x8DB3, 289 }, { 0x8DEF, 135 }, { 0x8DF3, 224 }, { 0x8F66, 25 },
+	{ 0x8F6C, 283 }, { 0x8F6F, 190 }, { 0x8F74, 281 }, { 0x8F7D, 267 },
+	{ 0x8F85, 62 }, { 0x8F91, 94 }, { 0x8F93, 206 }, { 0x8FB9, 11 },
+	{ 0x8FC1, 174 }, { 0x8FC5, 251 }, { 0x8FC7, 76 }, { 0x8FD0, 265 },
+	{ 0x8FD1, 100 }, { 0x8FD4, 56 }, { 0x8FD8, 89 }, { 0x8FD9, 276 },
+	{ 0x8FDB, 100 }, { 0x8FDC, 263 }, { 0x8FDE, 126 }, { 0x8FF7, 147 },
+	{ 0x9000, 231 }, { 0x9001, 211 }, { 0x9009, 249 }, { 0x901A, 227 },
+	{ 0x901F, 213 }, { 0x9020, 269 }, { 0x904D, 11 }, { 0x9053, 40 },
+	{ 0x90A3, 153 }, { 0x90AE, 261 }, { 0x90BB, 130 }, { 0x90E8, 16 },
+	{ 0x914D, 165 }, { 0x9152, 102 }, { 0x9177, 114 }, { 0x9192, 245 },
+	{ 0x91CC, 125 }, { 0x91CD, 280 }, { 0x91CF, 127 }, { 0x91D1, 100 },
+	{ 0x9488, 277 }, { 0x9489, 46 }, { 0x949F, 280 }, { 0x94A5, 255 },
+	{ 0x94AE, 160 }, { 0x94B1, 174 }, { 0x94C1, 225 }, { 0x94F6, 258 },
+	{ 0x94FE, 126 }, { 0x9500, 242 }, { 0x9501, 215 }, { 0x9519, 35 },
+	{ 0x952E, 96 }, { 0x955C, 101 }, { 0x957F, 24 }, { 0x95E8, 146 },
+	{ 0x95EE, 235 }, { 0x95F2, 240 }, { 0x95F4, 96 }, { 0x95F9, 155 },
+	{ 0x95FB, 235 }, { 0x9605, 264 }, { 0x961F, 51 }, { 0x9632, 57 },
+	{ 0x9633, 254 }, { 0x963F, 0 }, { 0x9645, 94 }, { 0x9646, 135 },
+	{ 0x964D, 97 }, { 0x9650, 240 }, { 0x9662, 263 }, { 0x9664, 29 },
+	{ 0x9669, 240 }, { 0x9690, 258 }, { 0x96C6, 94 }, { 0x96E8, 262 },
+	{ 0x96EA, 250 }, { 0x96F6, 131 }, { 0x96F7, 124 }, { 0x9738, 3 },
+	{ 0x9752, 178 }, { 0x975E, 58 }, { 0x9762, 148 }, { 0x97F3, 258 },
+	{ 0x9875, 256 }, { 0x9879, 241 }, { 0x9886, 131 }, { 0x9891, 170 },
+	{ 0x9898, 222 }, { 0x989C, 253 }, { 0x98CE, 60 }, { 0x98DE, 58 },
+	{ 0x9910, 18 }, { 0x997F, 53 }, { 0x9986, 72 }, { 0x9988, 117 },
+	{ 0x9996, 205 }, { 0x9A6C, 140 }, { 0x9A71, 180 }, { 0x9A8C, 253 },
+	{ 0x9AD8, 64 }, { 0x9B45, 145 }, { 0x9C7C, 262 }, { 0x9E1F, 159 },
+	{ 0x9E21, 94 }, { 0x9E92, 173 }, { 0x9E9F, 130 }, { 0x9EBB, 140 },
+	{ 0x9EC4, 90 }, { 0x9ED1, 82 }, { 0x9F20, 206 }, { 0x9F99, 133 }
+};
+
+//-----------------------------------------------------------------------------
+
+static const char* find_pinyin(gunichar c)
+{
+	if ((c < pinyin_table[0].codepoint) || (c > pinyin_table[G_N_ELEMENTS(pinyin_table) - 1].codepoint))
+	{
+		return NULL;
+	}
+
+	gsize first = 0, last = G_N_ELEMENTS(pinyin_table);
+	while (first < last)
+	{
+		gsize middle = (first + last) / 2;
+		if (pinyin_table[middle].codepoint < c)
+		{
+			first = middle + 1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+
+	if ((first < G_N_ELEMENTS(pinyin_table)) && (pinyin_table[first].codepoint == c))
+	{
+		return pinyin_syllables[pinyin_table[first].syllable];
+	}
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool is_vowel(char c)
+{
+	return (c == 'a') || (c == 'e') || (c == 'i') || (c == 'o') || (c == 'u');
+}
+
+//-----------------------------------------------------------------------------
+
+bool Transliteration::is_preferred()
+{
+	const gchar* const* languages = g_get_language_names();
+	return languages[0]
+			&& (g_str_has_prefix(languages[0], "zh") || g_str_has_prefix(languages[0], "ja"));
+}
+
+//-----------------------------------------------------------------------------
+
+std::string Transliteration::romanize(const std::string& text)
+{
+	std::string result;
+
+	// Skip strings that cannot contain Han or Kana
+	const gchar* pos = text.c_str();
+	for (; *pos; ++pos)
+	{
+		if (static_cast<guchar>(*pos) >= 0xE3)
+		{
+			break;
+		}
+	}
+	if (!*pos)
+	{
+		return result;
+	}
+
+	// Compose voiced kana that were decomposed by normalization
+	gchar* composed = g_utf8_normalize(text.c_str(), -1, G_NORMALIZE_DEFAULT_COMPOSE);
+	if (G_UNLIKELY(!composed))
+	{
+		return result;
+	}
+
+	bool romanized = false;
+	bool last_romanized = false;
+	bool sokuon = false;
+	std::string::size_type syllable_start = std::string::npos;
+	for (const gchar* c = composed; *c; c = g_utf8_next_char(c))
+	{
+		gunichar unichar = g_utf8_get_char(c);
+
+		// Map katakana onto hiragana
+		const char* syllable = NULL;
+		gunichar kana = unichar;
+		if ((kana >= 0x30A1) && (kana <= 0x30F6))
+		{
+			kana -= 0x60;
+		}
+
+		if ((kana >= 0x3041) && (kana <= 0x3096))
+		{
+			switch (kana)
+			{
+			// Small tsu doubles the next consonant
+			case 0x3063:
+				sokuon = true;
+				continue;
+
+			// Small ya, yu, and yo combine with the previous syllable
+			case 0x3083:
+			case 0x3085:
+			case 0x3087:
+				if ((syllable_start != std::string::npos) && (result.length() - syllable_start >= 2) && (result[result.length() - 1] == 'i'))
+				{
+					result.erase(result.length() - 1);
+					const std::string previous = result.substr(syllable_start);
+					if ((previous == "sh") || (previous == "ch") || (previous == "j"))
+					{
+						result += kana_table[kana - 0x3041][1];
+					}
+					else
+					{
+						result += kana_table[kana - 0x3041];
+					}
+					last_romanized = true;
+					continue;
+				}
+				break;
+
+			// Small vowels replace the vowel of the previous syllable
+			case 0x3041:
+			case 0x3043:
+			case 0x3045:
+			case 0x3047:
+			case 0x3049:
+				if ((syllable_start != std::string::npos) && (result.length() - syllable_start >= 2))
+				{
+					result[result.length() - 1] = kana_table[kana - 0x3041][0];
+					last_romanized = true;
+					continue;
+				}
+				break;
+
+			default:
+				break;
+			}
+			syllable = kana_table[kana - 0x3041];
+		}
+		else if ((unichar >= 0x30F7) && (unichar <= 0x30FA))
+		{
+			syllable = katakana_v_table[unichar - 0x30F7];
+		}
+		else if (unichar == 0x30FC)
+		{
+			// Long vowel mark repeats the previous vowel
+			if (last_romanized && !result.empty() && is_vowel(result[result.length() - 1]))
+			{
+				result += result[result.length() - 1];
+			}
+			continue;
+		}
+		else
+		{
+			syllable = find_pinyin(unichar);
+		}
+
+		if (syllable)
+		{
+			if (!last_romanized && !result.empty() && (result[result.length() - 1] != ' '))
+			{
+				result += ' ';
+			}
+			if (sokuon && !is_vowel(syllable[0]) && (syllable[0] != 'n'))
+			{
+				result += (syllable[0] == 'c') ? 't' : syllable[0];
+			}
+			sokuon = false;
+			syllable_start = result.length();
+			result += syllable;
+			romanized = true;
+			last_romanized = true;
+		}
+		else
+		{
+			// Separate romanized text from other words
+			if (last_romanized && !g_unichar_isspace(unichar))
+			{
+				result += ' ';
+			}
+			result.append(c, g_utf8_next_char(c) - c);
+			syllable_start = std::string::npos;
+			sokuon = false;
+			last_romanized = false;
+		}
+
+		if (result.length() >= romanized_length_max)
+		{
+			break;
+		}
+	}
+	g_free(composed);
+
+	// Only keep romanized string if anything was romanized
+	if (!romanized)
+	{
+		result.clear();
+	}
+	else if (result.length() > romanized_length_max)
+	{
+		// Romanized syllables are ASCII; only cut at a character boundary
+		std::string::size_type length = romanized_length_max;
+		while ((length > 0) && ((static_cast<guchar>(result[length]) & 0xC0) == 0x80))
+		{
+			--length;
+		}
+		result.erase(length);
+	}
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------
@@ -21,6 +21,7 @@
 #include "command.h"
 #include "favorites-page.h"
 #include "launcher-view.h"
+#include "memory-report.h"
 #include "profile-picture.h"
 #include "recent-page.h"
 #include "resizer-widget.h"
@@ -597,6 +598,15 @@ void BladeMenu::Window::save()
 
 //-----------------------------------------------------------------------------
 
+void BladeMenu::Window::load_settings()
+{
+	// Everything else is read from the settings each time the menu is shown
+	m_geometry.width = wm_settings->menu_width;
+	m_geometry.height = wm_settings->menu_height;
+}
+
+//-----------------------------------------------------------------------------
+
 void BladeMenu::Window::on_context_menu_destroyed()
 {
 	gdk_pointer_grab(gtk_widget_get_window(GTK_WIDGET(m_window)), true,
@@ -646,6 +656,16 @@ void BladeMenu::Window::unset_items()
 
 //-----------------------------------------------------------------------------
 
+void BladeMenu::Window::measure(MemoryReport& report) const
+{
+	m_applications->measure(report);
+	m_search_results->measure(report);
+	report.add_model(MemoryReport::Models, m_favorites->get_view()->get_model());
+	report.add_model(MemoryReport::Models, m_recent->get_view()->get_model());
+}
+
+//-----------------------------------------------------------------------------
+
 gboolean BladeMenu::Window::on_enter_notify_event(GtkWidget*, GdkEvent* event)
 {
 	GdkEventCrossing* crossing_event = reinterpret_cast<GdkEventCrossing*>(event);
@@ -27,6 +27,7 @@ namespace BladeMenu
 
 class ApplicationsPage;
 class FavoritesPage;
+class MemoryReport;
 class Page;
 class ProfilePicture;
 class ResizerWidget;
@@ -68,10 +69,12 @@ public:
 	void hide();
 	void show(GtkWidget* parent, bool horizontal);
 	void save();
+	void load_settings();
 	void on_context_menu_destroyed();
 	void set_categories(const std::vector<SectionButton*>& categories);
 	void set_items();
 	void unset_items();
+	void measure(MemoryReport& report) const;
 
 private:
 	gboolean on_enter_notify_event(GtkWidget*, GdkEvent* event);
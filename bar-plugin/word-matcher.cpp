@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "word-matcher.h"
+
+#include <algorithm>
+#include <deque>
+
+#include <climits>
+
+using namespace BladeMenu;
+
+//-----------------------------------------------------------------------------
+
+void WordMatcher::clear()
+{
+	m_nodes.clear();
+	m_lengths.clear();
+	m_found.clear();
+}
+
+//-----------------------------------------------------------------------------
+
+unsigned int WordMatcher::match(const SearchText& text, std::vector<SearchText::Span>* spans) const
+{
+	if (m_nodes.empty())
+	{
+		return UINT_MAX;
+	}
+
+	for (std::vector<std::vector<std::string::size_type> >::iterator i = m_found.begin(), end = m_found.end(); i != end; ++i)
+	{
+		i->clear();
+	}
+
+	// Scan text once, recording every word that starts at a word boundary
+	const std::string& haystack = text.str();
+	std::vector<Node>::size_type node = 0;
+	for (std::string::size_type i = 0, length = haystack.length(); i < length; ++i)
+	{
+		const unsigned char c = haystack[i];
+		std::map<unsigned char, std::vector<Node>::size_type>::const_iterator child;
+		while (((child = m_nodes[node].children.find(c)) == m_nodes[node].children.end()) && node)
+		{
+			node = m_nodes[node].fail;
+		}
+		if (child != m_nodes[node].children.end())
+		{
+			node = child->second;
+		}
+
+		const std::vector<std::vector<std::string>::size_type>& words = m_nodes[node].words;
+		for (std::vector<std::vector<std::string>::size_type>::const_iterator word = words.begin(), end = words.end(); word != end; ++word)
+		{
+			const std::string::size_type start = i + 1 - m_lengths[*word];
+			if (text.is_word_start(start))
+			{
+				m_found[*word].push_back(start);
+			}
+		}
+	}
+
+	// Check if every word was found; found positions of each word are sorted
+	for (std::vector<std::vector<std::string::size_type> >::const_iterator i = m_found.begin(), end = m_found.end(); i != end; ++i)
+	{
+		if (i->empty())
+		{
+			return UINT_MAX;
+		}
+	}
+
+	// Check if words were found in order, allowing them to overlap
+	unsigned int result = InOrder;
+	std::string::size_type pos = 0;
+	for (std::vector<std::vector<std::string::size_type> >::const_iterator i = m_found.begin(), end = m_found.end(); i != end; ++i)
+	{
+		std::vector<std::string::size_type>::const_iterator found = std::lower_bound(i->begin(), i->end(), pos);
+		if (found == i->end())
+		{
+			result = AnyOrder;
+			break;
+		}
+		pos = *found;
+	}
+
+	// Report where each word was found, at its first position unless in order
+	if (spans)
+	{
+		pos = 0;
+		for (std::vector<std::string>::size_type i = 0, end = m_found.size(); i < end; ++i)
+		{
+			if (result == InOrder)
+			{
+				pos = *std::lower_bound(m_found[i].begin(), m_found[i].end(), pos);
+			}
+			else
+			{
+				pos = m_found[i].front();
+			}
+			SearchText::Span span = { pos, pos + m_lengths[i] };
+			spans->push_back(span);
+		}
+	}
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+
+void WordMatcher::set_words(const std::vector<std::string>& words)
+{
+	clear();
+	m_nodes.push_back(Node());
+	m_nodes[0].fail = 0;
+	m_lengths.reserve(words.size());
+	m_found.resize(words.size());
+
+	// Build trie of words
+	for (std::vector<std::string>::size_type i = 0, end = words.size(); i < end; ++i)
+	{
+		const std::string& word = words[i];
+		m_lengths.push_back(word.length());
+
+		std::vector<Node>::size_type node = 0;
+		for (std::string::size_type j = 0, length = word.length(); j < length; ++j)
+		{
+			const unsigned char c = word[j];
+			std::map<unsigned char, std::vector<Node>::size_type>::const_iterator child = m_nodes[node].children.find(c);
+			if (child != m_nodes[node].children.end())
+			{
+				node = child->second;
+			}
+			else
+			{
+				m_nodes.push_back(Node());
+				m_nodes.back().fail = 0;
+				m_nodes[node].children[c] = m_nodes.size() - 1;
+				node = m_nodes.size() - 1;
+			}
+		}
+		m_nodes[node].words.push_back(i);
+	}
+
+	// Link each node to the longest suffix that is also in the trie, in
+	// breadth-first order so that shorter suffixes are linked first
+	std::deque<std::vector<Node>::size_type> queue;
+	for (std::map<unsigned char, std::vector<Node>::size_type>::const_iterator i = m_nodes[0].children.begin(), end = m_nodes[0].children.end(); i != end; ++i)
+	{
+		queue.push_back(i->second);
+	}
+	while (!queue.empty())
+	{
+		const std::vector<Node>::size_type node = queue.front();
+		queue.pop_front();
+
+		for (std::map<unsigned char, std::vector<Node>::size_type>::const_iterator i = m_nodes[node].children.begin(), end = m_nodes[node].children.end(); i != end; ++i)
+		{
+			std::vector<Node>::size_type fail = m_nodes[node].fail;
+			std::map<unsigned char, std::vector<Node>::size_type>::const_iterator child;
+			while (((child = m_nodes[fail].children.find(i->first)) == m_nodes[fail].children.end()) && fail)
+			{
+				fail = m_nodes[fail].fail;
+			}
+			Node& next = m_nodes[i->second];
+			next.fail = (child != m_nodes[fail].children.end()) ? child->second : 0;
+
+			// Report the words of the suffix as well
+			const std::vector<std::vector<std::string>::size_type>& words = m_nodes[next.fail].words;
+			next.words.insert(next.words.end(), words.begin(), words.end());
+
+			queue.push_back(i->second);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2017 Graeme Gott <graeme@gottcode.org>
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLADEMENU_WORD_MATCHER_H
+#define BLADEMENU_WORD_MATCHER_H
+
+#include "search-text.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace BladeMenu
+{
+
+class WordMatcher
+{
+public:
+	enum
+	{
+		InOrder = 0x20,
+		AnyOrder = 0x40
+	};
+
+	void clear();
+	unsigned int match(const SearchText& text, std::vector<SearchText::Span>* spans = NULL) const;
+	void set_words(const std::vector<std::string>& words);
+
+	std::vector<std::string>::size_type size() const
+	{
+		return m_lengths.size();
+	}
+
+private:
+	struct Node
+	{
+		std::map<unsigned char, std::vector<Node>::size_type> children;
+		std::vector<Node>::size_type fail;
+		std::vector<std::vector<std::string>::size_type> words;
+	};
+	std::vector<Node> m_nodes;
+	std::vector<std::string::size_type> m_lengths;
+
+	// Word start positions of each word found by the last match, which
+	// are kept to reuse their memory
+	mutable std::vector<std::vector<std::string::size_type> > m_found;
+};
+
+}
+
+#endif // BLADEMENU_WORD_MATCHER_H